@@ -0,0 +1,140 @@
+#include "AutoGain.h"
+#include "LevelMeter.h"
+
+// Rejilla de 20 Hz a 20 kHz (o hasta cerca de Nyquist) con el peso de la curva K en cada punto
+void AutoGain::prepareWeights(double sampleRate)
+{
+    const auto kWeighting = LevelMeter::makeKWeightingCoefficients(sampleRate);
+    const double maxFrequency = juce::jmin(20000.0, sampleRate * 0.45);
+
+    frequencies.clear();
+    weights.clear();
+
+    double totalWeight = 0.0;
+    for (double f = 20.0; f <= maxFrequency; f *= std::pow(2.0, 1.0 / pointsPerOctave))
+    {
+        const double k = kWeighting[0]->getMagnitudeForFrequency(f, sampleRate)
+                       * kWeighting[1]->getMagnitudeForFrequency(f, sampleRate);
+
+        frequencies.push_back(f);
+        weights.push_back(k * k);
+        totalWeight += k * k;
+    }
+
+    for (auto& w : weights)
+        w /= totalWeight;
+
+    weightsSampleRate = sampleRate;
+}
+
+bool AutoGain::Input::isCloseTo(const Input& other) const noexcept
+{
+    if (std::abs(sideShare - other.sideShare) > sideShareTolerance)
+        return false;
+
+    for (int component = 0; component < SimpleEQ::numComponents; ++component)
+        for (int band = 0; band < SimpleEQ::numBands; ++band)
+            if (std::abs(gainsDecibels[(size_t)component][(size_t)band] - other.gainsDecibels[(size_t)component][(size_t)band]) > gainToleranceDecibels)
+                return false;
+
+    return true;
+}
+
+// Relación de potencias ponderada entre la señal con EQ y sin EQ, invertida y en dB
+float AutoGain::computeCompensationDecibels(const Input& input) const
+{
+    // Potencia ponderada de las tres bandas en serie de una componente
+    auto componentPower = [this](const std::array<float, SimpleEQ::numBands>& gainsDecibels)
+        {
+            double power = 0.0;
+
+            for (size_t i = 0; i < frequencies.size(); ++i)
+            {
+                double magnitude = 1.0;
+                for (int band = 0; band < SimpleEQ::numBands; ++band)
+                    magnitude *= SimpleEQ::getMagnitudeForFrequency(band, gainsDecibels[(size_t)band], weightsSampleRate, frequencies[i]);
+
+                power += weights[i] * magnitude * magnitude;
+            }
+
+            return power;
+        };
+
+    const double share = juce::jlimit(0.0, 1.0, (double)input.sideShare);
+    double weightedPower = (1.0 - share) * componentPower(input.gainsDecibels[SimpleEQ::midComponent]);
+
+    if (share > 0.0)
+        weightedPower += share * componentPower(input.gainsDecibels[SimpleEQ::sideComponent]);
+
+    if (weightedPower <= 0.0)
+        return 0.0f;
+
+    return juce::jlimit(-maxCompensationDecibels, maxCompensationDecibels, (float)(-10.0 * std::log10(weightedPower)));
+}
+
+void AutoGain::update(const Input& input, double sampleRate)
+{
+    if (sampleRate <= 0.0)
+        return;
+
+    const bool rateChanged = sampleRate != weightsSampleRate;
+    if (! rateChanged && hasResult && input.isCloseTo(lastInput))
+        return;
+
+    if (rateChanged)
+        prepareWeights(sampleRate);
+
+    lastInput = input;
+    hasResult = true;
+
+    compensationGain.store(juce::Decibels::decibelsToGain(computeCompensationDecibels(input)), std::memory_order_relaxed);
+}
+
+// Energía de (L + R) y (L - R) con ocho acumuladores independientes (vectorizable, como LevelMeter)
+void AutoGain::measureStereoBalance(const juce::AudioBuffer<float>& buffer, double sampleRate) noexcept
+{
+    const int numSamples = buffer.getNumSamples();
+    if (buffer.getNumChannels() < 2 || numSamples == 0 || sampleRate <= 0.0)
+        return;
+
+    const float* left = buffer.getReadPointer(0);
+    const float* right = buffer.getReadPointer(1);
+
+    float midAcc[8] = {}, sideAcc[8] = {};
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            const float mid = left[i + j] + right[i + j];
+            const float side = left[i + j] - right[i + j];
+            midAcc[j] += mid * mid;
+            sideAcc[j] += side * side;
+        }
+    }
+
+    double blockMid = 0.0, blockSide = 0.0;
+    for (int j = 0; j < 8; ++j)
+    {
+        blockMid += midAcc[j];
+        blockSide += sideAcc[j];
+    }
+
+    for (; i < numSamples; ++i)
+    {
+        const float mid = left[i] + right[i];
+        const float side = left[i] - right[i];
+        blockMid += mid * mid;
+        blockSide += side * side;
+    }
+
+    const double alpha = 1.0 - std::exp(-(double)numSamples / (balanceTimeConstantSeconds * sampleRate));
+    midEnergy += alpha * (blockMid / numSamples - midEnergy);
+    sideEnergy += alpha * (blockSide / numSamples - sideEnergy);
+
+    // En silencio se mantiene el último reparto
+    const double total = midEnergy + sideEnergy;
+    if (total > 1.0e-12)
+        sideShare.store((float)(sideEnergy / total), std::memory_order_relaxed);
+}
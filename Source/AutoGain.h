@@ -0,0 +1,72 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+#include "SimpleEQ.h"    // Respuesta analítica de las bandas
+
+// Clase AutoGain: compensación de ganancia calculada a partir de la respuesta de la EQ, sin analizar el
+// espectro. Integra |H(f)|^2 de las tres bandas sobre un espectro de ruido rosa (misma energía por octava,
+// es decir puntos equiespaciados en escala logarítmica) ponderado con la curva K de sonoridad (BS.1770).
+// Solo cuenta las ganancias estáticas: las bandas dinámicas quedan fuera a propósito (su reducción debe
+// oírse, no compensarse con retraso). En M/S la potencia es la media de las de mid y side pesada con la
+// parte de la energía que lleva cada una, que el hilo de audio mide con dos sumas de cuadrados por bloque
+// (se supone el mismo espectro rosa en ambas).
+// Se recalcula fuera del hilo de audio y solo cuando la entrada cambia de forma apreciable; el hilo de
+// audio solo lee un atómico y la etapa de salida suaviza el cambio con su rampa.
+class AutoGain
+{
+public:
+    // Lo que determina la compensación: ganancias totales por componente y parte de la energía en side
+    // (0 en L/R, donde las ganancias de mid se aplican a los dos canales)
+    struct Input
+    {
+        std::array<std::array<float, SimpleEQ::numBands>, SimpleEQ::numComponents> gainsDecibels {};
+        float sideShare = 0.0f;
+
+        // Diferencias por debajo de lo audible no justifican recalcular la integral
+        bool isCloseTo(const Input& other) const noexcept;
+    };
+
+    AutoGain() = default;
+
+    // Recalcula la compensación si la entrada o la frecuencia de muestreo cambiaron (hilo de mensajes)
+    void update(const Input& input, double sampleRate);
+
+    // Hilo de audio: mide el reparto de energía entre mid y side del bloque (solo hace falta en M/S) y
+    // lo suaviza con una constante de tiempo de unos segundos para que la compensación no bombee
+    void measureStereoBalance(const juce::AudioBuffer<float>& buffer, double sampleRate) noexcept;
+
+    // Parte suavizada de la energía de la entrada que está en side, de 0 a 1 (cualquier hilo)
+    float getSideShare() const noexcept { return sideShare.load(std::memory_order_relaxed); }
+
+    // Ganancia lineal que devuelve la sonoridad estimada al nivel sin EQ (cualquier hilo)
+    float getCompensationGain() const noexcept { return compensationGain.load(std::memory_order_relaxed); }
+
+    // Fija la compensación sin calcularla (reproducción de una captura con el valor grabado)
+    void setCompensationGain(float gain) noexcept { compensationGain.store(gain, std::memory_order_relaxed); }
+
+    // Compensación en dB para una entrada dada (función pura, útil también para la interfaz)
+    float computeCompensationDecibels(const Input& input) const;
+
+private:
+    // Prepara la rejilla de frecuencias y los pesos de sonoridad para una frecuencia de muestreo
+    void prepareWeights(double sampleRate);
+
+    static constexpr float maxCompensationDecibels = 24.0f;
+    static constexpr int pointsPerOctave = 12;  // Resolución de la integración (1/12 de octava)
+    static constexpr float gainToleranceDecibels = 0.05f, sideShareTolerance = 0.01f;
+    static constexpr double balanceTimeConstantSeconds = 3.0;
+
+    double weightsSampleRate = 0.0;
+    std::vector<double> frequencies, weights;  // Frecuencias de la rejilla y peso |K(f)|^2 normalizado
+
+    Input lastInput;
+    bool hasResult = false;
+
+    // Energías suavizadas de mid y side (solo las toca el hilo de audio)
+    double midEnergy = 0.0, sideEnergy = 0.0;
+
+    std::atomic<float> compensationGain { 1.0f }, sideShare { 0.0f };
+
+    // Evita que la clase sea copiada accidentalmente
+    JUCE_DECLARE_NON_COPYABLE(AutoGain)
+};
@@ -0,0 +1,276 @@
+#include "AutomationRecorder.h"
+
+namespace
+{
+    // Los registros del hilo de audio se arman a mano: mismo orden de bytes que juce::OutputStream
+    inline char* writeLittleEndian(char* out, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(out, &value, 4);
+        return out + 4;
+    }
+
+    inline char* writeLittleEndian(char* out, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(out, &value, 2);
+        return out + 2;
+    }
+
+    inline juce::uint16 readLittleEndian16(const char* in) noexcept
+    {
+        juce::uint16 value;
+        std::memcpy(&value, in, 2);
+        return juce::ByteOrder::swapIfBigEndian(value);
+    }
+
+    inline float readLittleEndianFloat(const char* in) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, in, 4);
+        bits = juce::ByteOrder::swapIfBigEndian(bits);
+
+        float value;
+        std::memcpy(&value, &bits, 4);
+        return value;
+    }
+}
+
+// La FIFO se reserva en start(): sin captura la instancia no ocupa memoria extra
+AutomationRecorder::AutomationRecorder(juce::AudioProcessor& processorToCapture)
+    : juce::Thread("Filter_Flow automation writer"), processor(processorToCapture)
+{
+}
+
+AutomationRecorder::~AutomationRecorder()
+{
+    stop();
+}
+
+// Un archivo por prepareToPlay: fecha, hora y dirección de la instancia (varias instancias no se pisan)
+void AutomationRecorder::prepare(double sampleRate, int maximumBlockSize)
+{
+    stop();
+
+    const auto directory = juce::SystemStats::getEnvironmentVariable("FILTER_FLOW_CAPTURE", {});
+    if (directory.isEmpty() || ! juce::File::isAbsolutePath(directory))
+        return;
+
+    const auto name = "Filter_Flow_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S")
+                    + "_" + juce::String::toHexString((juce::pointer_sized_int)this) + ".ffac";
+
+    juce::File(directory).createDirectory();
+    start(juce::File(directory).getChildFile(name), sampleRate, maximumBlockSize);
+}
+
+bool AutomationRecorder::start(const juce::File& file, double sampleRate, int maximumBlockSize)
+{
+    stop();
+
+    file.deleteFile();
+    stream = std::make_unique<juce::FileOutputStream>(file);
+
+    if (stream->failedToOpen())
+    {
+        stream.reset();
+        return false;
+    }
+
+    const auto& parameters = processor.getParameters();
+
+    // Cabecera: formato, configuración de audio e IDs de los parámetros en el orden de getParameters()
+    stream->write("FFAC", 4);
+    stream->writeInt(formatVersion);
+    stream->writeDouble(sampleRate);
+    stream->writeInt(maximumBlockSize);
+    stream->writeInt(processor.getTotalNumInputChannels());
+    stream->writeInt(processor.getTotalNumOutputChannels());
+    stream->writeInt(parameters.size() + numExtraValues);
+
+    for (auto* parameter : parameters)
+    {
+        auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+        stream->writeString(withID != nullptr ? withID->paramID : juce::String(parameter->getParameterIndex()));
+    }
+
+    stream->writeString(hostBypassID);
+    stream->writeString(autoGainCompensationID);
+
+    // El primer bloque graba todos los valores
+    lastValues.assign((size_t)(parameters.size() + numExtraValues), std::numeric_limits<float>::quiet_NaN());
+
+    maxRecordSize = 6 + (parameters.size() + numExtraValues) * 6;
+    record.allocate((size_t)maxRecordSize, true);
+
+    if (fifoData == nullptr)
+        fifoData.allocate((size_t)fifo.getTotalSize(), false);
+
+    fifo.reset();
+    droppedBlocks.store(0);
+    recording.store(true, std::memory_order_release);
+
+    startThread();
+    return true;
+}
+
+void AutomationRecorder::stop()
+{
+    if (! recording.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    stopThread(1000);
+    drain();
+
+    stream->writeInt(-1);
+    stream->writeInt(droppedBlocks.load());
+    stream->flush();
+    stream.reset();
+}
+
+// El registro se arma en un buffer propio y entra entero en la FIFO, o no entra (se cuenta como perdido)
+void AutomationRecorder::captureBlock(int numSamples, bool hostBypassed, float autoGainCompensation) noexcept
+{
+    if (! recording.load(std::memory_order_acquire))
+        return;
+
+    const auto& parameters = processor.getParameters();
+    const int numParameters = juce::jmin(parameters.size(), (int)lastValues.size() - numExtraValues);
+    const int numValues = numParameters + numExtraValues;
+
+    char* out = writeLittleEndian(record.get(), (juce::uint32)numSamples);
+    char* countPosition = out;
+    out += 2;
+
+    juce::uint16 numChanges = 0;
+    for (int i = 0; i < numValues; ++i)
+    {
+        // Después de los parámetros van el bypass del host y la compensación de auto gain
+        const float value = i < numParameters ? parameters.getUnchecked(i)->getValue()
+                          : i == numParameters ? (hostBypassed ? 1.0f : 0.0f)
+                                               : autoGainCompensation;
+        if (value == lastValues[(size_t)i])
+            continue;
+
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, 4);
+        out = writeLittleEndian(writeLittleEndian(out, (juce::uint16)i), bits);
+        ++numChanges;
+    }
+
+    writeLittleEndian(countPosition, numChanges);
+    const int size = (int)(out - record.get());
+
+    if (fifo.getFreeSpace() < size)
+    {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;  // lastValues no cambia: el siguiente registro incluirá estos cambios
+    }
+
+    const auto scope = fifo.write(size);
+    std::memcpy(fifoData + scope.startIndex1, record.get(), (size_t)scope.blockSize1);
+    std::memcpy(fifoData + scope.startIndex2, record.get() + scope.blockSize1, (size_t)scope.blockSize2);
+
+    // Recién ahora los valores quedan como grabados
+    out = record.get() + 6;
+    for (int i = 0; i < numChanges; ++i, out += 6)
+        lastValues[readLittleEndian16(out)] = readLittleEndianFloat(out + 2);
+}
+
+void AutomationRecorder::drain()
+{
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    if (scope.blockSize1 > 0)
+        stream->write(fifoData + scope.startIndex1, (size_t)scope.blockSize1);
+    if (scope.blockSize2 > 0)
+        stream->write(fifoData + scope.startIndex2, (size_t)scope.blockSize2);
+}
+
+// Vuelca la FIFO 20 veces por segundo
+void AutomationRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        wait(50);
+        drain();
+    }
+}
+
+//==============================================================================
+AutomationRecorder::Reader::Reader(const juce::File& file) : stream(file) {}
+
+bool AutomationRecorder::Reader::readHeader(Header& header, juce::String& error)
+{
+    if (stream.failedToOpen())
+    {
+        error = "No se pudo abrir el archivo";
+        return false;
+    }
+
+    char magic[4] = {};
+    if (stream.read(magic, 4) != 4 || std::memcmp(magic, "FFAC", 4) != 0)
+    {
+        error = "No es una captura de Filter_Flow";
+        return false;
+    }
+
+    // La versión 1 no tiene el bypass del host ni la compensación de auto gain; se sigue leyendo igual
+    const int version = stream.readInt();
+    if (version < 1 || version > formatVersion)
+    {
+        error = "Version de formato no soportada: " + juce::String(version);
+        return false;
+    }
+
+    header.sampleRate = stream.readDouble();
+    header.maxBlockSize = stream.readInt();
+    header.numInputChannels = stream.readInt();
+    header.numOutputChannels = stream.readInt();
+    numParameters = stream.readInt();
+
+    if (numParameters < 0 || numParameters > 0xffff || header.sampleRate <= 0.0 || header.maxBlockSize <= 0)
+    {
+        error = "Cabecera invalida";
+        return false;
+    }
+
+    header.parameterIDs.clear();
+    for (int i = 0; i < numParameters; ++i)
+        header.parameterIDs.add(stream.readString());
+
+    return true;
+}
+
+bool AutomationRecorder::Reader::readNextBlock(Block& block)
+{
+    if (stream.getNumBytesRemaining() < 4)
+        return false;
+
+    block.numSamples = stream.readInt();
+
+    // Cierre: número de bloques perdidos
+    if (block.numSamples < 0)
+    {
+        droppedBlocks = stream.readInt();
+        return false;
+    }
+
+    const int numChanges = (juce::uint16)stream.readShort();
+
+    // Un registro cortado (captura interrumpida) termina la lectura
+    if (stream.getNumBytesRemaining() < (juce::int64)numChanges * 6)
+        return false;
+
+    block.changes.clear();
+
+    for (int i = 0; i < numChanges; ++i)
+    {
+        const int index = (juce::uint16)stream.readShort();
+        const float value = stream.readFloat();
+
+        if (index < numParameters)
+            block.changes.emplace_back(index, value);
+    }
+
+    return true;
+}
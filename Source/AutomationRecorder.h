@@ -0,0 +1,100 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase AutomationRecorder: captura por bloque el tamaño del bloque y los parámetros que cambiaron,
+// en un log binario compacto que Tools/AutomationReplay reproduce después de forma determinista.
+// Se activa con la variable de entorno FILTER_FLOW_CAPTURE (directorio absoluto); cada prepareToPlay
+// abre un archivo nuevo. El hilo de audio solo escribe en una FIFO sin locks; un hilo aparte la vuelca.
+//
+// Formato (little-endian):
+//   "FFAC", int versión, double sampleRate, int maxBlockSize, int canales de entrada, int canales de salida,
+//   int número de parámetros, y el ID de cada parámetro (UTF-8 terminado en 0). Desde la versión 2 la
+//   lista termina con dos valores que no son parámetros: el bypass pedido por el host (processBlockBypassed)
+//   y la compensación de auto gain que calculó el timer del hilo de mensajes
+//   Por bloque: int numSamples, uint16 cambios, y por cada cambio: uint16 índice, float valor normalizado
+//   Al cerrar: int -1 e int bloques perdidos (FIFO llena)
+class AutomationRecorder : private juce::Thread
+{
+public:
+    static constexpr int formatVersion = 2;
+
+    // IDs de los valores grabados que no son parámetros (al final de la lista de la cabecera)
+    static constexpr const char* hostBypassID = "#hostBypass";
+    static constexpr const char* autoGainCompensationID = "#autoGainCompensation";
+
+    explicit AutomationRecorder(juce::AudioProcessor& processorToCapture);
+    ~AutomationRecorder() override;
+
+    // Si FILTER_FLOW_CAPTURE indica un directorio, cierra la captura anterior y abre una nueva
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    // Abre un archivo de captura y arranca el hilo de escritura (fuera del hilo de audio)
+    bool start(const juce::File& file, double sampleRate, int maximumBlockSize);
+
+    // Vuelca lo pendiente, escribe el cierre y detiene el hilo
+    void stop();
+
+    bool isRecording() const noexcept { return recording.load(std::memory_order_acquire); }
+
+    // Hilo de audio: registra un bloque con los parámetros que cambiaron desde el anterior, el bypass del
+    // host y la compensación de auto gain (ganancia lineal) vigentes en este bloque
+    void captureBlock(int numSamples, bool hostBypassed, float autoGainCompensation) noexcept;
+
+    // Lectura de un archivo de captura (la usa el reproductor)
+    class Reader
+    {
+    public:
+        struct Header
+        {
+            double sampleRate = 0.0;
+            int maxBlockSize = 0, numInputChannels = 0, numOutputChannels = 0;
+            juce::StringArray parameterIDs;
+        };
+
+        struct Block
+        {
+            int numSamples = 0;
+            std::vector<std::pair<int, float>> changes;  // Índice de parámetro y valor normalizado
+        };
+
+        explicit Reader(const juce::File& file);
+
+        // Lee y valida la cabecera; en caso de error devuelve false y describe el problema
+        bool readHeader(Header& header, juce::String& error);
+
+        // Lee el siguiente bloque; devuelve false al llegar al cierre o al final del archivo
+        bool readNextBlock(Block& block);
+
+        // Bloques que no se pudieron grabar (solo se conoce al leer el cierre)
+        int getDroppedBlocks() const noexcept { return droppedBlocks; }
+
+    private:
+        juce::FileInputStream stream;
+        int numParameters = 0, droppedBlocks = 0;
+    };
+
+private:
+    void run() override;
+
+    // Pasa el contenido de la FIFO al archivo (hilo de escritura y stop())
+    void drain();
+
+    // Número de valores grabados después de los parámetros (bypass del host y auto gain)
+    static constexpr int numExtraValues = 2;
+
+    juce::AudioProcessor& processor;
+
+    juce::AbstractFifo fifo { 1 << 20 };
+    juce::HeapBlock<char> fifoData;  // 1 MiB, reservado recién al abrir la primera captura
+
+    std::vector<float> lastValues;  // Últimos valores grabados (NaN = forzar escritura)
+    juce::HeapBlock<char> record;   // Registro del bloque en construcción
+    int maxRecordSize = 0;
+
+    std::unique_ptr<juce::FileOutputStream> stream;
+    std::atomic<bool> recording { false };
+    std::atomic<int> droppedBlocks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(AutomationRecorder)
+};
@@ -0,0 +1,126 @@
+#include "BypassStage.h"
+
+// Reserva todo en prepare: el hilo de audio nunca asigna memoria
+void BypassStage::prepare(double sampleRate, int maximumBlockSize, int numChannels, int maximumLatency)
+{
+    fadeStep = 1.0f / juce::jmax(1.0f, (float)(fadeSeconds * sampleRate));
+    maxLatency = juce::jmax(0, maximumLatency);
+    latency = juce::jmin(latency, maxLatency);
+
+    // El bloque entero se escribe antes de leerlo: el buffer tiene que guardar latencia + bloque
+    const int delaySize = juce::nextPowerOfTwo(maxLatency + juce::jmax(1, maximumBlockSize) + 1);
+    delayBuffer.setSize(juce::jmax(0, numChannels), delaySize);
+    delayMask = delaySize - 1;
+
+    reset();
+}
+
+void BypassStage::reset()
+{
+    delayBuffer.clear();
+    writePosition = blockStart = 0;
+
+    wetGain = bypassed ? 0.0f : 1.0f;
+    holdSamples = 0;
+}
+
+void BypassStage::setBypassed(bool shouldBeBypassed) noexcept
+{
+    if (shouldBeBypassed == bypassed)
+        return;
+
+    // La cadena arranca limpia: su salida es silencio hasta que el retardo se llena
+    if (! shouldBeBypassed && isFullyBypassed())
+        holdSamples = latency;
+
+    bypassed = shouldBeBypassed;
+
+    // Un bypass pedido durante la espera no necesita fundido: todavía no se oye la cadena
+    if (bypassed)
+        holdSamples = 0;
+}
+
+void BypassStage::setLatency(int newLatency) noexcept
+{
+    latency = juce::jlimit(0, maxLatency, newLatency);
+}
+
+void BypassStage::pushDry(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayBuffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+    const int delaySize = delayMask + 1;
+
+    blockStart = writePosition;
+
+    // Copia en uno o dos tramos según dónde da la vuelta el buffer circular
+    const int first = juce::jmin(numSamples, delaySize - writePosition);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        delayBuffer.copyFrom(ch, writePosition, buffer, ch, 0, first);
+        if (first < numSamples)
+            delayBuffer.copyFrom(ch, 0, buffer, ch, first, numSamples - first);
+    }
+
+    writePosition = (writePosition + numSamples) & delayMask;
+}
+
+void BypassStage::process(juce::AudioBuffer<float>& buffer) noexcept
+{
+    const bool fading = holdSamples > 0 || wetGain != (bypassed ? 0.0f : 1.0f);
+
+    // Procesando sin fundido: la salida es la de la cadena
+    if (! bypassed && ! fading)
+        return;
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayBuffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+    const int readStart = (blockStart - latency) & delayMask;
+
+    // Bypass estable: copia la señal seca retrasada
+    if (! fading)
+    {
+        const int delaySize = delayMask + 1;
+        const int first = juce::jmin(numSamples, delaySize - readStart);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            buffer.copyFrom(ch, 0, delayBuffer, ch, readStart, first);
+            if (first < numSamples)
+                buffer.copyFrom(ch, first, delayBuffer, ch, 0, numSamples - first);
+        }
+
+        for (int ch = numChannels; ch < buffer.getNumChannels(); ++ch)
+            buffer.clear(ch, 0, numSamples);
+
+        return;
+    }
+
+    // Fundido: la ganancia avanza por muestra y es la misma para todos los canales
+    const float target = bypassed ? 0.0f : 1.0f;
+    const float startGain = wetGain;
+    const int startHold = holdSamples;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* data = buffer.getWritePointer(ch);
+        const float* dry = delayBuffer.getReadPointer(ch);
+
+        float gain = startGain;
+        int hold = startHold;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (hold > 0)
+                --hold;
+            else if (gain != target)
+                gain = target > gain ? juce::jmin(target, gain + fadeStep) : juce::jmax(target, gain - fadeStep);
+
+            const float drySample = dry[(readStart + i) & delayMask];
+            data[i] = drySample + gain * (data[i] - drySample);
+        }
+
+        wetGain = gain;
+        holdSamples = hold;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase BypassStage: bypass sin clicks. La entrada pasa siempre por una línea de retardo igual a la
+// latencia reportada, así la señal seca queda alineada con la procesada; al activar o desactivar el
+// bypass se hace un fundido corto entre ambas. En bypass estable la cadena no se procesa: solo el retardo.
+class BypassStage
+{
+public:
+    static constexpr double fadeSeconds = 0.01;  // Duración del fundido (10 ms)
+
+    BypassStage() = default;
+
+    // Reserva la línea de retardo para la latencia máxima y el tamaño máximo de bloque
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, int maximumLatency);
+
+    // Vacía el retardo y salta al estado pedido, sin fundido
+    void reset();
+
+    // Pide bypass o proceso; el cambio se hace con un fundido. Al salir de un bypass estable, la cadena
+    // (que se reinicia) tarda "latencia" muestras en dar audio: hasta entonces se mantiene la señal seca
+    void setBypassed(bool shouldBeBypassed) noexcept;
+
+    // Retardo de la señal seca en muestras (la latencia que el plugin reporta al host)
+    void setLatency(int newLatency) noexcept;
+
+    // Bypass estable: la salida es solo la señal seca y la cadena no hace falta
+    bool isFullyBypassed() const noexcept { return bypassed && wetGain == 0.0f; }
+
+    // Escribe la entrada del bloque en la línea de retardo (antes de procesar la cadena)
+    void pushDry(const juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Mezcla la señal seca retrasada con la salida de la cadena que ya está en el buffer (in-place).
+    // En bypass estable copia la seca; procesando sin fundido no hace nada
+    void process(juce::AudioBuffer<float>& buffer) noexcept;
+
+private:
+    bool bypassed = false;
+    float wetGain = 1.0f;      // Proporción de señal procesada: 1 = proceso, 0 = bypass
+    float fadeStep = 0.01f;    // Cambio de wetGain por muestra durante el fundido
+    int holdSamples = 0;       // Muestras que faltan antes de empezar el fundido hacia la señal procesada
+
+    // Línea de retardo por canal (tamaño potencia de dos, mayor que latencia + bloque)
+    juce::AudioBuffer<float> delayBuffer;
+    int delayMask = 0, writePosition = 0, blockStart = 0;
+    int latency = 0, maxLatency = 0;
+
+    // Evita que la clase sea copiada accidentalmente
+    JUCE_DECLARE_NON_COPYABLE(BypassStage)
+};
@@ -0,0 +1,110 @@
+#include "CpuGovernor.h"
+
+const CpuGovernor::Settings& CpuGovernor::getSettings(Tier tier) noexcept
+{
+    static const Settings settings[(int)Tier::numTiers] =
+    {
+        {  1,  8, 3, true,  30, "Full" },
+        {  8, 16, 1, true,  15, "Reduced" },
+        { 32, 32, 0, false, 10, "Minimal" }
+    };
+
+    return settings[juce::jlimit(0, (int)Tier::numTiers - 1, (int)tier)];
+}
+
+void CpuGovernor::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    reset();
+}
+
+void CpuGovernor::reset() noexcept
+{
+    smoothedLoad = 0.0;
+    smoothedLateness = 1.0;
+    previousStartTicks = 0;
+    previousBlockSeconds = 0.0;
+    consecutiveOverloads = 0;
+    headroomSeconds = secondsSinceChange = 0.0;
+
+    if (! forced)
+        tier.store(Tier::full, std::memory_order_relaxed);
+
+    load.store(0.0f, std::memory_order_relaxed);
+    lateness.store(1.0f, std::memory_order_relaxed);
+}
+
+void CpuGovernor::setEnabled(bool shouldBeEnabled) noexcept
+{
+    if (shouldBeEnabled == enabled)
+        return;
+
+    enabled = shouldBeEnabled;
+
+    if (! enabled && ! forced)
+        changeTier((int)Tier::full);
+}
+
+void CpuGovernor::forceTier(Tier newTier) noexcept
+{
+    forced = true;
+    changeTier((int)newTier);
+}
+
+void CpuGovernor::changeTier(int newTier) noexcept
+{
+    tier.store(static_cast<Tier>(juce::jlimit(0, (int)Tier::numTiers - 1, newTier)), std::memory_order_relaxed);
+
+    consecutiveOverloads = 0;
+    headroomSeconds = secondsSinceChange = 0.0;
+}
+
+// Baja de nivel tras varias sobrecargas seguidas; sube tras varios segundos con margen suficiente
+void CpuGovernor::addMeasurement(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept
+{
+    if (numSamples <= 0 || currentSampleRate <= 0.0)
+        return;
+
+    const double blockSeconds = numSamples / currentSampleRate;
+    const double blockLoad = (double)(endTicks - startTicks) * secondsPerTick / blockSeconds;
+
+    // Suavizado con constante de tiempo de ~0.5 s, independiente del tamaño de bloque
+    const double alpha = 1.0 - std::exp(-blockSeconds / 0.5);
+    smoothedLoad += alpha * (blockLoad - smoothedLoad);
+    load.store((float)smoothedLoad, std::memory_order_relaxed);
+
+    // Separación desde el comienzo de la llamada anterior frente al audio que entregó esa llamada.
+    // Los drivers que llaman a ráfagas alternan valores altos y bajos; la media es lo que cuenta
+    if (previousStartTicks != 0)
+    {
+        const double ratio = (double)(startTicks - previousStartTicks) * secondsPerTick / previousBlockSeconds;
+
+        if (ratio < pauseRatio)
+        {
+            smoothedLateness += alpha * (ratio - smoothedLateness);
+            lateness.store((float)smoothedLateness, std::memory_order_relaxed);
+        }
+    }
+
+    previousStartTicks = startTicks;
+    previousBlockSeconds = blockSeconds;
+
+    if (! enabled || forced)
+        return;
+
+    const bool hostLate = smoothedLateness > latenessThreshold;
+
+    secondsSinceChange += blockSeconds;
+    consecutiveOverloads = (blockLoad > overloadThreshold || hostLate) ? consecutiveOverloads + 1 : 0;
+    headroomSeconds = (smoothedLoad < headroomThreshold && ! hostLate) ? headroomSeconds + blockSeconds : 0.0;
+
+    if (secondsSinceChange < holdSecondsAfterChange)
+        return;
+
+    const int current = (int)getTier();
+
+    if (consecutiveOverloads >= overloadsToStepDown && current < (int)Tier::numTiers - 1)
+        changeTier(current + 1);
+    else if (headroomSeconds >= headroomSecondsToStepUp && current > (int)Tier::full)
+        changeTier(current - 1);
+}
@@ -0,0 +1,114 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase CpuGovernor: mide la presión de CPU y, si se mantiene, baja un nivel de calidad; cuando vuelve a
+// sobrar margen durante un rato, sube de nuevo. Hay dos señales de presión:
+//   - Carga propia: lo que tarda este processBlock frente a la duración del bloque. Solo detecta el caso en
+//     que esta instancia sola se come la mitad del presupuesto.
+//   - Retraso del host: el tiempo entre el comienzo de dos llamadas seguidas frente a la duración del bloque.
+//     Con cientos de instancias, cada una gasta poco pero el host entero se atrasa: las llamadas llegan de
+//     media más separadas que el audio que entregan, y eso lo ve cada instancia aunque su carga sea baja.
+// Los umbrales de bajada y subida están separados (histéresis) y tras cada cambio hay una espera mínima
+// para que la medida se estabilice. En directo, una EQ algo más barata es mejor que un corte de audio.
+class CpuGovernor
+{
+public:
+    // Niveles de calidad, de mayor a menor coste
+    enum class Tier
+    {
+        full = 0,  // Todo a resolución completa
+        reduced,   // Menos pasos de coeficientes y true peak con una sola fase intermedia
+        minimal,   // Coeficientes por sub-bloque, true peak sin interpolar y sin medidor de entrada
+        numTiers
+    };
+
+    // Ajustes que corresponden a cada nivel: cada uno quita trabajo por muestra o por bloque en el hilo de
+    // audio. Ninguno cambia la latencia: el sobremuestreo de la saturación queda fijo en 4x y el detector de
+    // true peak mantiene su retardo aunque evalúe menos fases, porque mover la latencia reportada en pleno
+    // bloque haría saltar la salida
+    struct Settings
+    {
+        int smoothingInterval;       // Muestras entre pasos de la interpolación de coeficientes SVF
+        int dynamicRampStep;         // Muestras entre cambios de coeficientes biquad de las bandas dinámicas
+        int truePeakPhases;          // Fases intermedias que evalúa el detector de true peak (3, 1 o 0)
+        bool measureInput;           // Medidor de pico y RMS de la entrada
+        int editorRefreshHz;         // Frecuencia de refresco de medidores y curvas en la interfaz
+        const char* name;
+    };
+
+    static const Settings& getSettings(Tier tier) noexcept;
+
+    // Mide un bloque de principio a fin (también si la función sale antes)
+    class ScopedMeasurement
+    {
+    public:
+        ScopedMeasurement(CpuGovernor& g, int numSamplesToMeasure) noexcept
+            : governor(g), numSamples(numSamplesToMeasure), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedMeasurement() noexcept { governor.addMeasurement(startTicks, juce::Time::getHighResolutionTicks(), numSamples); }
+
+    private:
+        CpuGovernor& governor;
+        const int numSamples;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedMeasurement)
+    };
+
+    CpuGovernor() = default;
+
+    // Guarda la frecuencia de muestreo y vuelve a la calidad máxima
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Activa o desactiva el gobernador; desactivado se queda en calidad máxima (también en render offline,
+    // donde el ritmo de las llamadas no dice nada sobre el tiempo real)
+    void setEnabled(bool shouldBeEnabled) noexcept;
+
+    // Herramientas de medida (LoadSimulator): fija un nivel y deja de decidir. Se llama antes de procesar
+    void forceTier(Tier newTier) noexcept;
+
+    // Nivel actual, carga propia suavizada (fracción del tiempo real de cada bloque) y retraso suavizado del
+    // host (separación entre llamadas / duración del bloque, 1 = al día); se leen desde cualquier hilo
+    Tier getTier() const noexcept { return tier.load(std::memory_order_relaxed); }
+    float getLoad() const noexcept { return load.load(std::memory_order_relaxed); }
+    float getHostLateness() const noexcept { return lateness.load(std::memory_order_relaxed); }
+
+private:
+    // Acumula la medida de un bloque y decide si hay que cambiar de nivel (hilo de audio)
+    void addMeasurement(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept;
+
+    void changeTier(int newTier) noexcept;
+
+    // Umbrales sobre la carga propia de cada bloque (tiempo de proceso / duración del bloque). El de
+    // sobrecarga supone que esta instancia tiene el procesador para ella sola: con muchas instancias no se
+    // alcanza y la que decide es la señal de retraso del host
+    static constexpr double overloadThreshold = 0.5;   // Por encima, el bloque cuenta como sobrecarga
+    static constexpr double headroomThreshold = 0.2;   // Por debajo de esto (suavizado) hay margen
+
+    // Umbrales sobre el retraso suavizado del host: un 5 % por encima de tiempo real de forma sostenida es
+    // que el host pierde plazos. Separaciones de más de 4 bloques son pausas del transporte, no sobrecarga
+    static constexpr double latenessThreshold = 1.05;
+    static constexpr double pauseRatio = 4.0;
+    static constexpr int overloadsToStepDown = 8;      // Sobrecargas seguidas para bajar de nivel
+    static constexpr double headroomSecondsToStepUp = 5.0;  // Segundos con margen para subir de nivel
+    static constexpr double holdSecondsAfterChange = 1.0;   // Espera mínima entre cambios
+
+    bool enabled = true;
+    double currentSampleRate = 44100.0;
+    double secondsPerTick = 1.0 / (double)juce::Time::getHighResolutionTicksPerSecond();
+
+    bool forced = false;
+    double smoothedLoad = 0.0, smoothedLateness = 1.0;
+    juce::int64 previousStartTicks = 0;
+    double previousBlockSeconds = 0.0;
+    int consecutiveOverloads = 0;
+    double headroomSeconds = 0.0, secondsSinceChange = 0.0;
+
+    std::atomic<Tier> tier { Tier::full };
+    std::atomic<float> load { 0.0f }, lateness { 1.0f };
+
+    // Evita que la clase sea copiada accidentalmente
+    JUCE_DECLARE_NON_COPYABLE(CpuGovernor)
+};
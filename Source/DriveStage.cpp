@@ -0,0 +1,148 @@
+#include "DriveStage.h"
+
+namespace
+{
+    // Recorte suave cúbico normalizado: llega a 1.0 con pendiente 0 en |x| = 1
+    inline float cubicClip(float x) noexcept
+    {
+        x = std::min(1.0f, std::max(-1.0f, x));
+        return x * (1.5f - 0.5f * x * x);
+    }
+
+    // Aproximación racional de tanh, exacta en |x| = 3 y sin std::tanh
+    inline float rationalTanh(float x) noexcept
+    {
+        x = std::min(3.0f, std::max(-3.0f, x));
+        const float x2 = x * x;
+        return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+
+    // Polarización de la curva asimétrica y su valor en reposo. Restarlo solo quita la continua en
+    // silencio: con señal la curva genera una continua que depende del nivel (la quita removeDC)
+    constexpr float asymmetricBias = 0.2f;
+    const float asymmetricOffset = rationalTanh(asymmetricBias);
+}
+
+DriveStage::DriveStage()
+{
+    inputGain.setRampDurationSeconds(0.02);  // Rampa de 20 ms para cambios de drive
+}
+
+// Crea los filtros de sobremuestreo para el número de canales actual
+void DriveStage::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // IIR polifase con latencia entera: barato y la latencia se puede reportar al host
+    oversampling = std::make_unique<juce::dsp::Oversampling<float>>(spec.numChannels, oversamplingFactorLog2,
+        juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, false, true);
+    oversampling->initProcessing(static_cast<size_t>(spec.maximumBlockSize));
+
+    inputGain.prepare(spec);
+
+    dcBlockerCoefficient = (float)std::exp(-juce::MathConstants<double>::twoPi * dcBlockerFrequency / spec.sampleRate);
+    dcBlockerState.resize(spec.numChannels);
+
+    reset();
+}
+
+void DriveStage::reset()
+{
+    if (oversampling != nullptr)
+        oversampling->reset();
+
+    inputGain.reset();
+    std::fill(dcBlockerState.begin(), dcBlockerState.end(), std::make_pair(0.0f, 0.0f));
+}
+
+void DriveStage::setParameters(Curve newCurve, float driveDecibels)
+{
+    // Al reactivar la etapa se limpian los filtros para no arrastrar estado antiguo
+    if (curve == Curve::off && newCurve != Curve::off)
+        reset();
+
+    // El bloqueador de continua solo corre con la curva asimétrica: al volver a ella arranca limpio
+    if (curve != Curve::asymmetric && newCurve == Curve::asymmetric)
+        std::fill(dcBlockerState.begin(), dcBlockerState.end(), std::make_pair(0.0f, 0.0f));
+
+    curve = newCurve;
+    inputGain.setGainDecibels(driveDecibels);
+}
+
+int DriveStage::getLatencyInSamples() const noexcept
+{
+    if (! isActive() || oversampling == nullptr)
+        return 0;
+
+    return juce::roundToInt(oversampling->getLatencyInSamples());
+}
+
+// Evalúa la curva sobre un canal; cada caso es un bucle sin ramas que el compilador vectoriza
+void DriveStage::shape(float* data, int numSamples) const noexcept
+{
+    switch (curve)
+    {
+        case Curve::cubic:
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = cubicClip(data[i]);
+            break;
+
+        case Curve::tanh:
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = rationalTanh(data[i]);
+            break;
+
+        case Curve::asymmetric:
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = rationalTanh(data[i] + asymmetricBias) - asymmetricOffset;
+            break;
+
+        case Curve::off:
+        case Curve::numCurves:
+        default:
+            break;
+    }
+}
+
+// Aplica drive a la frecuencia base, sube, satura, y vuelve a bajar a la frecuencia original
+void DriveStage::process(juce::AudioBuffer<float>& buffer)
+{
+    if (! isActive() || oversampling == nullptr)
+        return;
+
+    juce::dsp::AudioBlock<float> block(buffer);
+    inputGain.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+    auto oversampledBlock = oversampling->processSamplesUp(block);
+
+    const int numSamples = static_cast<int>(oversampledBlock.getNumSamples());
+    for (size_t ch = 0; ch < oversampledBlock.getNumChannels(); ++ch)
+        shape(oversampledBlock.getChannelPointer(ch), numSamples);
+
+    oversampling->processSamplesDown(block);
+
+    if (curve == Curve::asymmetric)
+        removeDC(buffer);
+}
+
+// Filtro pasa altos de un polo por canal; la recursión impide vectorizar, pero es una sola
+// multiplicación por muestra y solo con la curva asimétrica
+void DriveStage::removeDC(juce::AudioBuffer<float>& buffer) noexcept
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int)dcBlockerState.size());
+    const int numSamples = buffer.getNumSamples();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* data = buffer.getWritePointer(ch);
+        auto [x1, y1] = dcBlockerState[(size_t)ch];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = data[i];
+            y1 = x - x1 + dcBlockerCoefficient * y1;
+            x1 = x;
+            data[i] = y1;
+        }
+
+        dcBlockerState[(size_t)ch] = { x1, y1 };
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase DriveStage: saturación opcional con sobremuestreo limitado a esta etapa no lineal
+// Las curvas se evalúan con aproximaciones polinómicas/racionales en bucles sin saltos (vectorizables)
+class DriveStage
+{
+public:
+    // Curvas de saturación (el orden coincide con las opciones del parámetro "driveCurve")
+    enum class Curve
+    {
+        off = 0,     // Etapa desactivada: no añade latencia ni coste
+        cubic,       // Recorte suave cúbico: 1.5x - 0.5x^3
+        tanh,        // Aproximación racional de tanh (Padé)
+        asymmetric,  // Tanh con polarización: añade armónicos pares
+        numCurves
+    };
+
+    DriveStage();  // Constructor
+
+    // Prepara el sobremuestreo y la ganancia de entrada con las especificaciones de audio
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    // Limpia el estado de los filtros de sobremuestreo
+    void reset();
+
+    // Cambia la curva y la cantidad de drive (en decibeles)
+    void setParameters(Curve newCurve, float driveDecibels);
+
+    // Indica si la etapa está procesando audio (curva distinta de "off")
+    bool isActive() const noexcept { return curve != Curve::off; }
+
+    // Latencia añadida por los filtros de sobremuestreo (0 si la etapa está desactivada)
+    int getLatencyInSamples() const noexcept;
+
+    // Procesa el buffer (in-place); solo esta etapa trabaja a la frecuencia sobremuestreada
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    // Aplica la curva seleccionada a un canal del bloque sobremuestreado
+    void shape(float* data, int numSamples) const noexcept;
+
+    // Quita la continua que deja la curva asimétrica con señal (a la frecuencia base, tras bajar)
+    void removeDC(juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Factor de sobremuestreo como potencia de dos (2 -> 4x)
+    static constexpr int oversamplingFactorLog2 = 2;
+
+    // Bloqueador de continua de un polo: y[n] = x[n] - x[n-1] + R * y[n-1], corte en ~7 Hz
+    static constexpr double dcBlockerFrequency = 7.0;
+
+    Curve curve = Curve::off;
+
+    float dcBlockerCoefficient = 0.999f;                  // R = exp(-2 pi fc / fs)
+    std::vector<std::pair<float, float>> dcBlockerState;  // (x[n-1], y[n-1]) por canal
+
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;  // Filtros polifase de subida/bajada
+    juce::dsp::Gain<float> inputGain;                              // Drive con rampa, a la frecuencia base
+
+    // Evita que la clase sea copiada accidentalmente
+    JUCE_DECLARE_NON_COPYABLE(DriveStage)
+};
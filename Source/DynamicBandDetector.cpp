@@ -0,0 +1,67 @@
+#include "DynamicBandDetector.h"
+#include "LevelMeter.h"
+
+void DynamicBandDetector::prepare(double sampleRate, int maximumBlockSize, int subBlockSize,
+                                  juce::dsp::IIR::Coefficients<float>::Ptr bandFilterCoefficients)
+{
+    currentSampleRate = sampleRate;
+    subBlock = juce::jmax(1, subBlockSize);
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    bandFilter.coefficients = bandFilterCoefficients;
+    bandFilter.prepare({ sampleRate, (juce::uint32)maxBlockSize, 1 });
+
+    filtered.allocate((size_t)maxBlockSize, true);
+
+    setSettings(settings);  // Recalcula attack/release para la nueva frecuencia de muestreo
+    reset();
+}
+
+void DynamicBandDetector::reset()
+{
+    bandFilter.reset();
+    envelopeDecibels = floorDecibels;
+}
+
+// Las constantes de tiempo se convierten a coeficientes por sub-bloque (la envolvente avanza a ese ritmo)
+void DynamicBandDetector::setSettings(const Settings& newSettings)
+{
+    if (settings.enabled && ! newSettings.enabled)
+        reset();
+
+    settings = newSettings;
+
+    const double subBlockSeconds = subBlock / currentSampleRate;
+    attackCoefficient = (float)std::exp(-subBlockSeconds / (juce::jmax(0.01f, settings.attackMilliseconds) * 0.001));
+    releaseCoefficient = (float)std::exp(-subBlockSeconds / (juce::jmax(0.01f, settings.releaseMilliseconds) * 0.001));
+}
+
+void DynamicBandDetector::process(const float* key, int numSamples, float* gainsOut) noexcept
+{
+    numSamples = juce::jmin(numSamples, maxBlockSize);
+
+    // Filtra una copia de la señal de control a la zona de la banda
+    juce::FloatVectorOperations::copy(filtered.get(), key, numSamples);
+
+    float* channels[] = { filtered.get() };
+    juce::dsp::AudioBlock<float> block(channels, 1, (size_t)numSamples);
+    bandFilter.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+    const float slope = 1.0f - 1.0f / juce::jmax(1.0f, settings.ratio);
+
+    for (int start = 0, index = 0; start < numSamples; start += subBlock, ++index)
+    {
+        const int length = juce::jmin(subBlock, numSamples - start);
+
+        // Nivel RMS del sub-bloque en dB (reducción vectorizable, sin trabajo por muestra en la envolvente)
+        const float meanSquare = LevelMeter::sumOfSquares(filtered.get() + start, length) / (float)length;
+        const float levelDecibels = juce::jmax(floorDecibels, 10.0f * std::log10(meanSquare + 1.0e-12f));
+
+        const float coefficient = levelDecibels > envelopeDecibels ? attackCoefficient : releaseCoefficient;
+        envelopeDecibels = levelDecibels + coefficient * (envelopeDecibels - levelDecibels);
+
+        // Compresión de la banda por encima del umbral
+        const float over = envelopeDecibels - settings.thresholdDecibels;
+        gainsOut[index] = over > 0.0f ? -juce::jmin(maxReductionDecibels, over * slope) : 0.0f;
+    }
+}
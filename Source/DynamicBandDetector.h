@@ -0,0 +1,56 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase DynamicBandDetector: detector de envolvente de una banda dinámica de la EQ.
+// Filtra la señal de control (entrada principal o sidechain) a la zona de la banda y mide su nivel
+// RMS por sub-bloques; la envolvente (attack/release) y la curva de compresión (threshold/ratio) se
+// calculan una vez por sub-bloque, no por muestra. El resultado es un ajuste de ganancia en dB (<= 0).
+class DynamicBandDetector
+{
+public:
+    struct Settings
+    {
+        bool enabled = false;
+        float thresholdDecibels = -20.0f;
+        float ratio = 2.0f;
+        float attackMilliseconds = 10.0f;
+        float releaseMilliseconds = 150.0f;
+    };
+
+    DynamicBandDetector() = default;
+
+    // Prepara el filtro de la banda y el buffer temporal; subBlockSize es la resolución de la envolvente
+    void prepare(double sampleRate, int maximumBlockSize, int subBlockSize,
+                 juce::dsp::IIR::Coefficients<float>::Ptr bandFilterCoefficients);
+
+    // Limpia el filtro y devuelve la envolvente al reposo
+    void reset();
+
+    // Cambia los ajustes; al desactivar la banda la envolvente se reinicia
+    void setSettings(const Settings& newSettings);
+
+    bool isEnabled() const noexcept { return settings.enabled; }
+
+    // Analiza numSamples muestras (<= maximumBlockSize) de la señal de control en mono y escribe el
+    // ajuste de ganancia en dB de cada sub-bloque en gainsOut
+    void process(const float* key, int numSamples, float* gainsOut) noexcept;
+
+private:
+    static constexpr float maxReductionDecibels = 24.0f;
+    static constexpr float floorDecibels = -120.0f;
+
+    Settings settings;
+    double currentSampleRate = 44100.0;
+    int subBlock = 32;
+
+    juce::dsp::IIR::Filter<float> bandFilter;
+    juce::HeapBlock<float> filtered;
+    int maxBlockSize = 0;
+
+    float envelopeDecibels = floorDecibels;
+    float attackCoefficient = 0.0f, releaseCoefficient = 0.0f;
+
+    // Evita que la clase sea copiada accidentalmente
+    JUCE_DECLARE_NON_COPYABLE(DynamicBandDetector)
+};
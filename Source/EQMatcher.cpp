@@ -0,0 +1,360 @@
+#include "EQMatcher.h"
+
+namespace
+{
+    // Rejilla logarítmica de 1/6 de octava desde 20 Hz hasta ~18 kHz
+    constexpr int numGridPoints = 60;
+
+    double gridFrequency(int index)
+    {
+        return 20.0 * std::pow(2.0, index / 6.0);
+    }
+
+    // Rango en el que se compara el espectro (fuera de él dominan el ruido y los filtros antialias)
+    constexpr double fitMinFrequency = 30.0;
+    constexpr double fitMaxFrequency = 16000.0;
+}
+
+//==============================================================================
+// Trabajo del pool: analiza un tramo de un archivo leyendo bloques de fftSize con 50 % de solapamiento
+class EQMatcher::SegmentJob : public juce::ThreadPoolJob
+{
+public:
+    SegmentJob(juce::AudioFormatManager& manager, const juce::File& fileToRead,
+               juce::int64 first, juce::int64 last, SpectrumAccumulator& destination)
+        : juce::ThreadPoolJob("EQ match segment"),
+          formatManager(manager), file(fileToRead), startSample(first), endSample(last), accumulator(destination)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        // Cada trabajo abre su propio lector: así los tramos se leen en paralelo
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+            return jobHasFinished;
+
+        juce::dsp::FFT fft(fftOrder);
+        juce::dsp::WindowingFunction<float> window((size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+
+        const int numChannels = juce::jmax(1, (int)reader->numChannels);
+        juce::AudioBuffer<float> readBuffer(numChannels, fftSize);
+        std::vector<float> fftData((size_t)fftSize * 2);
+
+        accumulator.power.assign((size_t)fftSize / 2 + 1, 0.0);
+        accumulator.sampleRate = reader->sampleRate;
+
+        constexpr int hopSize = fftSize / 2;
+
+        for (juce::int64 position = startSample; position + fftSize <= endSample; position += hopSize)
+        {
+            if (shouldExit())
+                return jobHasFinished;
+
+            reader->read(&readBuffer, 0, fftSize, position, true, true);
+
+            // Mezcla a mono (promedio de canales)
+            std::fill(fftData.begin(), fftData.end(), 0.0f);
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(fftData.data(), readBuffer.getReadPointer(ch), 1.0f / (float)numChannels, fftSize);
+
+            window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+            fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+            for (size_t bin = 0; bin < accumulator.power.size(); ++bin)
+                accumulator.power[bin] += (double)fftData[bin] * (double)fftData[bin];
+
+            ++accumulator.numFrames;
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    juce::AudioFormatManager& formatManager;
+    juce::File file;
+    juce::int64 startSample, endSample;
+    SpectrumAccumulator& accumulator;
+};
+
+//==============================================================================
+EQMatcher::EQMatcher()
+    : juce::Thread("EQ match")
+{
+    formatManager.registerBasicFormats();  // WAV, AIFF, FLAC, Ogg, etc.
+}
+
+EQMatcher::~EQMatcher()
+{
+    cancel();
+}
+
+void EQMatcher::startMatch(const juce::File& reference, const juce::File& target, double sampleRate,
+                           std::function<void(const Result&)> onFinished)
+{
+    cancel();
+
+    referenceFile = reference;
+    targetFile = target;
+    pluginSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    callback = std::move(onFinished);
+
+    startThread(juce::Thread::Priority::low);
+}
+
+void EQMatcher::cancel()
+{
+    // El hilo coordinador vacía y destruye su pool al ver la señal
+    signalThreadShouldExit();
+    stopThread(4000);
+}
+
+// Reparte el archivo en tramos (dos por hilo del pool) y encola un trabajo por tramo
+bool EQMatcher::addJobsForFile(juce::ThreadPool& pool, const juce::File& file,
+                               std::vector<std::unique_ptr<SpectrumAccumulator>>& accumulators, juce::String& error)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        error = "No se pudo abrir " + file.getFileName();
+        return false;
+    }
+
+    const juce::int64 length = reader->lengthInSamples;
+    if (length < fftSize)
+    {
+        error = file.getFileName() + " es demasiado corto";
+        return false;
+    }
+
+    const int numSegments = (int)juce::jlimit((juce::int64)1, (juce::int64)pool.getNumThreads() * 2, length / (fftSize * 16));
+    const juce::int64 segmentLength = length / numSegments;
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const juce::int64 first = i * segmentLength;
+        const juce::int64 last = (i == numSegments - 1) ? length : first + segmentLength;
+
+        accumulators.push_back(std::make_unique<SpectrumAccumulator>());
+        pool.addJob(new SegmentJob(formatManager, file, first, last, *accumulators.back()), true);
+    }
+
+    return true;
+}
+
+// Suma los tramos y promedia la potencia de los bins que caen en cada banda de la rejilla
+std::vector<double> EQMatcher::toLogSpectrum(const std::vector<std::unique_ptr<SpectrumAccumulator>>& accumulators)
+{
+    std::vector<double> total((size_t)fftSize / 2 + 1, 0.0);
+    int frames = 0;
+    double sampleRate = 0.0;
+
+    for (auto& a : accumulators)
+    {
+        if (a->numFrames == 0)
+            continue;
+
+        for (size_t bin = 0; bin < total.size(); ++bin)
+            total[bin] += a->power[bin];
+
+        frames += a->numFrames;
+        sampleRate = a->sampleRate;
+    }
+
+    std::vector<double> spectrum((size_t)numGridPoints, 0.0);
+    if (frames == 0 || sampleRate <= 0.0)
+        return spectrum;
+
+    const double binWidth = sampleRate / fftSize;
+    const double halfBand = std::pow(2.0, 1.0 / 12.0);  // Medio sexto de octava
+
+    for (int i = 0; i < numGridPoints; ++i)
+    {
+        const double centre = gridFrequency(i);
+        const int firstBin = juce::jlimit(1, fftSize / 2, (int)std::ceil(centre / halfBand / binWidth));
+        const int lastBin = juce::jlimit(1, fftSize / 2, (int)std::floor(centre * halfBand / binWidth));
+
+        double sum = 0.0;
+        int count = 0;
+        for (int bin = firstBin; bin <= lastBin; ++bin, ++count)
+            sum += total[(size_t)bin];
+
+        // En graves la banda puede ser más estrecha que un bin: se usa el bin más cercano
+        if (count == 0)
+        {
+            sum = total[(size_t)juce::jlimit(1, fftSize / 2, juce::roundToInt(centre / binWidth))];
+            count = 1;
+        }
+
+        spectrum[(size_t)i] = sum / (count * (double)frames);
+    }
+
+    return spectrum;
+}
+
+// Gauss-Newton sobre las tres ganancias. El nivel global se descarta (se ajusta solo la forma del espectro):
+// el residuo y las columnas del jacobiano se centran en su media ponderada en cada iteración.
+std::array<float, SimpleEQ::numBands> EQMatcher::fitGains(const std::vector<double>& referenceSpectrum,
+                                                          const std::vector<double>& targetSpectrum) const
+{
+    constexpr int numBands = SimpleEQ::numBands;
+    std::array<float, numBands> gains {};
+
+    // Diferencia deseada en dB y peso de cada punto (0 fuera de rango o sin energía)
+    std::vector<double> desired((size_t)numGridPoints, 0.0), weights((size_t)numGridPoints, 0.0);
+    double weightSum = 0.0;
+
+    for (int i = 0; i < numGridPoints; ++i)
+    {
+        const double f = gridFrequency(i);
+        const double ref = referenceSpectrum[(size_t)i], tgt = targetSpectrum[(size_t)i];
+
+        if (f < fitMinFrequency || f > fitMaxFrequency || f >= pluginSampleRate * 0.45 || ref <= 1.0e-12 || tgt <= 1.0e-12)
+            continue;
+
+        desired[(size_t)i] = 10.0 * std::log10(ref / tgt);
+        weights[(size_t)i] = 1.0;
+        weightSum += 1.0;
+    }
+
+    if (weightSum == 0.0)
+        return gains;
+
+    auto bandResponse = [this](int band, float gain, int point)
+        {
+            return 20.0 * std::log10(juce::jmax(1.0e-6f, SimpleEQ::getMagnitudeForFrequency(band, gain, pluginSampleRate, gridFrequency(point))));
+        };
+
+    auto centre = [&](std::vector<double>& values)
+        {
+            double mean = 0.0;
+            for (int i = 0; i < numGridPoints; ++i)
+                mean += weights[(size_t)i] * values[(size_t)i];
+            mean /= weightSum;
+            for (auto& v : values)
+                v -= mean;
+        };
+
+    for (int iteration = 0; iteration < 12; ++iteration)
+    {
+        if (threadShouldExit())
+            break;
+
+        // Residuo actual y jacobiano numérico (diferencia central de 0.1 dB)
+        std::vector<double> residual((size_t)numGridPoints);
+        std::array<std::vector<double>, numBands> jacobian;
+
+        for (int i = 0; i < numGridPoints; ++i)
+        {
+            double model = 0.0;
+            for (int b = 0; b < numBands; ++b)
+                model += bandResponse(b, gains[(size_t)b], i);
+            residual[(size_t)i] = desired[(size_t)i] - model;
+        }
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            jacobian[(size_t)b].resize((size_t)numGridPoints);
+            for (int i = 0; i < numGridPoints; ++i)
+                jacobian[(size_t)b][(size_t)i] = (bandResponse(b, gains[(size_t)b] + 0.05f, i) - bandResponse(b, gains[(size_t)b] - 0.05f, i)) / 0.1;
+            centre(jacobian[(size_t)b]);
+        }
+
+        centre(residual);
+
+        // Ecuaciones normales (J^T W J + lambda I) delta = J^T W r, resueltas por eliminación gaussiana
+        double A[numBands][numBands + 1] = {};
+        for (int r = 0; r < numBands; ++r)
+        {
+            for (int c = 0; c < numBands; ++c)
+                for (int i = 0; i < numGridPoints; ++i)
+                    A[r][c] += weights[(size_t)i] * jacobian[(size_t)r][(size_t)i] * jacobian[(size_t)c][(size_t)i];
+
+            A[r][r] += 1.0e-3 * weightSum;  // Pequeña regularización para bandas sin efecto en el rango
+
+            for (int i = 0; i < numGridPoints; ++i)
+                A[r][numBands] += weights[(size_t)i] * jacobian[(size_t)r][(size_t)i] * residual[(size_t)i];
+        }
+
+        for (int pivot = 0; pivot < numBands; ++pivot)
+        {
+            for (int r = pivot + 1; r < numBands; ++r)
+            {
+                const double factor = A[r][pivot] / A[pivot][pivot];
+                for (int c = pivot; c <= numBands; ++c)
+                    A[r][c] -= factor * A[pivot][c];
+            }
+        }
+
+        double delta[numBands] = {};
+        for (int r = numBands - 1; r >= 0; --r)
+        {
+            double sum = A[r][numBands];
+            for (int c = r + 1; c < numBands; ++c)
+                sum -= A[r][c] * delta[c];
+            delta[r] = sum / A[r][r];
+        }
+
+        double largestStep = 0.0;
+        for (int b = 0; b < numBands; ++b)
+        {
+            gains[(size_t)b] = juce::jlimit(-24.0f, 24.0f, gains[(size_t)b] + (float)delta[b]);
+            largestStep = juce::jmax(largestStep, std::abs(delta[b]));
+        }
+
+        if (largestStep < 0.01)
+            break;  // Convergió
+    }
+
+    return gains;
+}
+
+// Hilo coordinador
+void EQMatcher::run()
+{
+    Result result;
+    std::vector<std::unique_ptr<SpectrumAccumulator>> referenceParts, targetParts;
+
+    // El pool se crea aquí y se destruye al salir (antes que los acumuladores que usan sus trabajos):
+    // las instancias que nunca hacen "EQ match" no tienen hilos de análisis
+    juce::ThreadPool pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1));
+
+    // Los dos archivos se analizan a la vez: todos sus tramos van al mismo pool
+    if (! addJobsForFile(pool, referenceFile, referenceParts, result.message)
+        || ! addJobsForFile(pool, targetFile, targetParts, result.message))
+    {
+        pool.removeAllJobs(true, 4000);
+    }
+    else
+    {
+        while (pool.getNumJobs() > 0)
+        {
+            if (threadShouldExit())
+            {
+                pool.removeAllJobs(true, 4000);
+                return;
+            }
+
+            wait(20);
+        }
+
+        const auto referenceSpectrum = toLogSpectrum(referenceParts);
+        const auto targetSpectrum = toLogSpectrum(targetParts);
+
+        result.gains = fitGains(referenceSpectrum, targetSpectrum);
+        result.succeeded = ! threadShouldExit();
+        result.message = juce::String::formatted("Match: low %+.1f dB, mid %+.1f dB, high %+.1f dB",
+                                                 result.gains[0], result.gains[1], result.gains[2]);
+    }
+
+    if (threadShouldExit())
+        return;
+
+    // Entrega el resultado en el hilo de mensajes (si el EQMatcher sigue vivo)
+    juce::WeakReference<EQMatcher> weakThis(this);
+    juce::MessageManager::callAsync([weakThis, result]
+        {
+            if (weakThis != nullptr && weakThis->callback != nullptr)
+                weakThis->callback(result);
+        });
+}
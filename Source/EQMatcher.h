@@ -0,0 +1,71 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+#include "SimpleEQ.h"    // Para evaluar la respuesta de las bandas al ajustar las ganancias
+
+// Clase EQMatcher: "EQ match" entre un archivo de referencia y un archivo objetivo.
+// Ambos espectros se calculan en paralelo en un pool de hilos que solo existe mientras dura el análisis (FFT con ventana y promedio por tramos,
+// leyendo el archivo por bloques, sin cargarlo entero en memoria) y después se ajustan las ganancias
+// de las bandas de SimpleEQ para que el objetivo se parezca a la referencia. Nunca toca el hilo de audio.
+class EQMatcher : private juce::Thread
+{
+public:
+    // Resultado del análisis (se entrega en el hilo de mensajes)
+    struct Result
+    {
+        bool succeeded = false;
+        juce::String message;                           // Descripción del resultado o del error
+        std::array<float, SimpleEQ::numBands> gains {};  // Ganancias ajustadas en dB (low, mid, high)
+    };
+
+    EQMatcher();
+    ~EQMatcher() override;
+
+    // Lanza el análisis en segundo plano. onFinished se llama en el hilo de mensajes cuando termina.
+    // sampleRate es la frecuencia a la que trabaja el plugin (para evaluar la respuesta de los filtros).
+    void startMatch(const juce::File& reference, const juce::File& target, double sampleRate,
+                    std::function<void(const Result&)> onFinished);
+
+    // Cancela un análisis en curso (el callback no se llama)
+    void cancel();
+
+    // Indica si hay un análisis en curso
+    bool isMatching() const noexcept { return isThreadRunning(); }
+
+private:
+    // Espectro de potencia promedio de una parte de un archivo
+    struct SpectrumAccumulator
+    {
+        std::vector<double> power;  // Suma de |X(k)|^2 por bin
+        int numFrames = 0;          // Cantidad de ventanas sumadas
+        double sampleRate = 0.0;
+    };
+
+    class SegmentJob;
+
+    // Hilo coordinador: reparte los trabajos, espera, ajusta las ganancias y entrega el resultado
+    void run() override;
+
+    // Reparte un archivo en tramos y añade un trabajo por tramo al pool
+    bool addJobsForFile(juce::ThreadPool& pool, const juce::File& file,
+                        std::vector<std::unique_ptr<SpectrumAccumulator>>& accumulators, juce::String& error);
+
+    // Combina los tramos de un archivo y promedia la potencia en bandas de 1/6 de octava
+    static std::vector<double> toLogSpectrum(const std::vector<std::unique_ptr<SpectrumAccumulator>>& accumulators);
+
+    // Ajusta las ganancias por mínimos cuadrados (Gauss-Newton) a la diferencia en dB entre espectros
+    std::array<float, SimpleEQ::numBands> fitGains(const std::vector<double>& referenceSpectrum,
+                                                   const std::vector<double>& targetSpectrum) const;
+
+    static constexpr int fftOrder = 13;            // FFT de 8192 puntos (~6 Hz por bin a 48 kHz)
+    static constexpr int fftSize = 1 << fftOrder;
+
+    juce::AudioFormatManager formatManager;
+
+    juce::File referenceFile, targetFile;
+    double pluginSampleRate = 44100.0;
+    std::function<void(const Result&)> callback;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(EQMatcher)
+    JUCE_DECLARE_NON_COPYABLE(EQMatcher)
+};
@@ -0,0 +1,236 @@
+#include "LevelMeter.h"
+
+LevelMeter::LevelMeter(bool shouldMeasureLoudness) : measureLoudness(shouldMeasureLoudness)
+{
+    for (auto& p : peak) p.store(0.0f);
+    for (auto& r : rms) r.store(0.0f);
+}
+
+// Coeficientes de la ponderación K (BS.1770) para una frecuencia de muestreo
+std::array<juce::dsp::IIR::Coefficients<float>::Ptr, 2> LevelMeter::makeKWeightingCoefficients(double sampleRate)
+{
+    std::array<juce::dsp::IIR::Coefficients<float>::Ptr, 2> coefficients;
+
+    // Etapa 1: shelf de agudos (+4 dB por encima de ~1.7 kHz, modelo de la cabeza)
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, Q = 0.7071752369554196;
+        const double K = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double Vh = std::pow(10.0, gainDb / 20.0);
+        const double Vb = std::pow(Vh, 0.4996667741545416);
+
+        coefficients[0] = new juce::dsp::IIR::Coefficients<float>(
+            (float)(Vh + Vb * K / Q + K * K), (float)(2.0 * (K * K - Vh)), (float)(Vh - Vb * K / Q + K * K),
+            (float)(1.0 + K / Q + K * K), (float)(2.0 * (K * K - 1.0)), (float)(1.0 - K / Q + K * K));
+    }
+
+    // Etapa 2: pasa altos RLB (~38 Hz)
+    {
+        const double f0 = 38.13547087602444, Q = 0.5003270373238773;
+        const double K = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+
+        coefficients[1] = new juce::dsp::IIR::Coefficients<float>(
+            1.0f, -2.0f, 1.0f,
+            (float)(1.0 + K / Q + K * K), (float)(2.0 * (K * K - 1.0)), (float)(1.0 - K / Q + K * K));
+    }
+
+    return coefficients;
+}
+
+// Calcula la ponderación K para la frecuencia de muestreo actual y prepara los filtros
+void LevelMeter::prepare(double sampleRate, int maximumBlockSize, int numChannels)
+{
+    numPreparedChannels = juce::jmax(0, numChannels);
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    if (measureLoudness)
+    {
+        const auto coefficients = makeKWeightingCoefficients(sampleRate);
+        shelfCoefficients = coefficients[0];
+        highPassCoefficients = coefficients[1];
+
+        juce::dsp::ProcessSpec monoSpec { sampleRate, (juce::uint32)maxBlockSize, 1 };
+
+        kWeighting.resize((size_t)numPreparedChannels);
+        for (auto& filters : kWeighting)
+        {
+            filters[0].coefficients = shelfCoefficients;
+            filters[1].coefficients = highPassCoefficients;
+            filters[0].prepare(monoSpec);
+            filters[1].prepare(monoSpec);
+        }
+
+        weighted.allocate((size_t)maxBlockSize, true);
+    }
+
+    rmsTimeConstantSamples = 0.3 * sampleRate;            // Ventana RMS de ~300 ms
+    chunkLength = juce::jmax(1, juce::roundToInt(0.1 * sampleRate));  // Tramos de 100 ms
+
+    reset();
+}
+
+void LevelMeter::reset()
+{
+    for (auto& filters : kWeighting)
+        for (auto& filter : filters)
+            filter.reset();
+
+    meanSquare.fill(0.0);
+    chunkEnergy.fill(0.0);
+    chunkIndex = chunksFilled = 0;
+    currentChunkEnergy = 0.0;
+    currentChunkSamples = 0;
+    histogramCounts.fill(0);
+    histogramEnergy.fill(0.0);
+
+    for (auto& p : peak) p.store(0.0f);
+    for (auto& r : rms) r.store(0.0f);
+    momentaryLufs.store(silenceLufs);
+    shortTermLufs.store(silenceLufs);
+    integratedLufs.store(silenceLufs);
+}
+
+// Ocho acumuladores independientes rompen la dependencia entre iteraciones y permiten usar SIMD
+float LevelMeter::sumOfSquares(const float* data, int numSamples) noexcept
+{
+    float acc[8] = {};
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+        for (int j = 0; j < 8; ++j)
+            acc[j] += data[i + j] * data[i + j];
+
+    float sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+
+    for (; i < numSamples; ++i)
+        sum += data[i] * data[i];
+
+    return sum;
+}
+
+float LevelMeter::energyToLufs(double energy) noexcept
+{
+    if (energy <= 0.0)
+        return silenceLufs;
+
+    return juce::jmax(silenceLufs, (float)(-0.691 + 10.0 * std::log10(energy)));
+}
+
+float LevelMeter::getAndResetPeak(int channel) noexcept
+{
+    return peak[(size_t)channel].exchange(0.0f, std::memory_order_relaxed);
+}
+
+void LevelMeter::process(const juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), numPreparedChannels);
+
+    if (numSamples == 0 || numChannels == 0)
+        return;
+
+    // Pico y RMS por canal: una reducción por bloque en lugar de recorrer muestra a muestra
+    const double alpha = 1.0 - std::exp(-(double)numSamples / rmsTimeConstantSamples);
+
+    for (int ch = 0; ch < juce::jmin(numChannels, maxChannels); ++ch)
+    {
+        const float* data = buffer.getReadPointer(ch);
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+        const float blockPeak = juce::jmax(-range.getStart(), range.getEnd());
+
+        // Publica el máximo desde la última lectura (la interfaz lo pone a cero al leerlo)
+        auto previous = peak[(size_t)ch].load(std::memory_order_relaxed);
+        while (blockPeak > previous && ! peak[(size_t)ch].compare_exchange_weak(previous, blockPeak, std::memory_order_relaxed)) {}
+
+        const double blockMeanSquare = sumOfSquares(data, numSamples) / numSamples;
+        meanSquare[(size_t)ch] += alpha * (blockMeanSquare - meanSquare[(size_t)ch]);
+        rms[(size_t)ch].store((float)std::sqrt(meanSquare[(size_t)ch]), std::memory_order_relaxed);
+    }
+
+    if (! measureLoudness)
+        return;
+
+    // Sonoridad: ponderación K por canal y energía acumulada en tramos de 100 ms
+    for (int position = 0; position < numSamples;)
+    {
+        const int length = juce::jmin(numSamples - position, chunkLength - currentChunkSamples, maxBlockSize);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            juce::FloatVectorOperations::copy(weighted.get(), buffer.getReadPointer(ch, position), length);
+
+            float* channels[] = { weighted.get() };
+            juce::dsp::AudioBlock<float> block(channels, 1, (size_t)length);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+
+            kWeighting[(size_t)ch][0].process(context);
+            kWeighting[(size_t)ch][1].process(context);
+
+            currentChunkEnergy += sumOfSquares(weighted.get(), length);  // Peso 1.0 para L y R
+        }
+
+        currentChunkSamples += length;
+        position += length;
+
+        if (currentChunkSamples == chunkLength)
+            finishLoudnessChunk();
+    }
+}
+
+// Cada 100 ms: ventana momentánea (4 tramos), de corto plazo (30 tramos) e histograma para la integrada
+void LevelMeter::finishLoudnessChunk() noexcept
+{
+    chunkEnergy[(size_t)chunkIndex] = currentChunkEnergy / chunkLength;
+    chunkIndex = (chunkIndex + 1) % numChunks;
+    chunksFilled = juce::jmin(chunksFilled + 1, numChunks);
+    currentChunkEnergy = 0.0;
+    currentChunkSamples = 0;
+
+    auto meanOfLastChunks = [this](int count)
+        {
+            double sum = 0.0;
+            for (int i = 1; i <= count; ++i)
+                sum += chunkEnergy[(size_t)((chunkIndex - i + numChunks) % numChunks)];
+            return sum / count;
+        };
+
+    shortTermLufs.store(energyToLufs(meanOfLastChunks(chunksFilled)), std::memory_order_relaxed);
+
+    if (chunksFilled < 4)
+        return;
+
+    const double momentaryEnergy = meanOfLastChunks(4);
+    const float momentary = energyToLufs(momentaryEnergy);
+    momentaryLufs.store(momentary, std::memory_order_relaxed);
+
+    // Compuerta absoluta de -70 LUFS: solo entran al histograma los bloques por encima
+    if (momentary < histogramMinLufs)
+        return;
+
+    const int bin = juce::jlimit(0, histogramSize - 1, (int)((momentary - histogramMinLufs) / histogramStep));
+    ++histogramCounts[(size_t)bin];
+    histogramEnergy[(size_t)bin] += momentaryEnergy;
+
+    // Compuerta relativa: 10 LU por debajo de la media de los bloques que pasaron la absoluta
+    double totalEnergy = 0.0;
+    juce::uint64 totalCount = 0;
+    for (int i = 0; i < histogramSize; ++i)
+    {
+        totalEnergy += histogramEnergy[(size_t)i];
+        totalCount += histogramCounts[(size_t)i];
+    }
+
+    const float relativeGate = energyToLufs(totalEnergy / (double)totalCount) - 10.0f;
+    const int firstBin = juce::jlimit(0, histogramSize, (int)std::ceil((relativeGate - histogramMinLufs) / histogramStep));
+
+    double gatedEnergy = 0.0;
+    juce::uint64 gatedCount = 0;
+    for (int i = firstBin; i < histogramSize; ++i)
+    {
+        gatedEnergy += histogramEnergy[(size_t)i];
+        gatedCount += histogramCounts[(size_t)i];
+    }
+
+    if (gatedCount > 0)
+        integratedLufs.store(energyToLufs(gatedEnergy / (double)gatedCount), std::memory_order_relaxed);
+}
@@ -0,0 +1,88 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase LevelMeter: medidor de pico, RMS y sonoridad ITU-R BS.1770 (LUFS) para un punto de la cadena.
+// Mide en el hilo de audio con reducciones por bloque (bucles con varios acumuladores que el compilador
+// vectoriza) y publica los valores en atómicos: la interfaz los lee sin ningún lock.
+// La sonoridad es lo caro (dos biquads por muestra y canal), así que es opcional: un medidor sin ella solo
+// calcula pico y RMS, dos reducciones por bloque.
+class LevelMeter
+{
+public:
+    static constexpr int maxChannels = 2;  // Pico y RMS se publican para los dos primeros canales
+
+    // Constructor: shouldMeasureLoudness activa la ponderación K y las medidas LUFS
+    explicit LevelMeter(bool shouldMeasureLoudness);
+
+    // Prepara los filtros de ponderación K (si mide sonoridad) y los buffers temporales
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+
+    // Vuelve a cero todas las medidas (incluida la sonoridad integrada)
+    void reset();
+
+    // Mide el buffer (no lo modifica)
+    void process(const juce::AudioBuffer<float>& buffer);
+
+    // Lectura desde la interfaz -------------------------------------------------------------
+
+    // Pico máximo desde la última lectura (lineal); la lectura lo vuelve a cero
+    float getAndResetPeak(int channel) noexcept;
+
+    // RMS con ventana de ~300 ms (lineal)
+    float getRms(int channel) const noexcept { return rms[(size_t)channel].load(std::memory_order_relaxed); }
+
+    // Sonoridad momentánea (400 ms), de corto plazo (3 s) e integrada con compuertas, en LUFS
+    // (siempre silenceLufs en un medidor sin sonoridad)
+    float getMomentaryLoudness() const noexcept { return momentaryLufs.load(std::memory_order_relaxed); }
+    float getShortTermLoudness() const noexcept { return shortTermLufs.load(std::memory_order_relaxed); }
+    float getIntegratedLoudness() const noexcept { return integratedLufs.load(std::memory_order_relaxed); }
+
+    // Valor que se publica cuando no hay señal suficiente para medir sonoridad
+    static constexpr float silenceLufs = -100.0f;
+
+    // Suma de cuadrados de un bloque con 8 acumuladores independientes (vectorizable)
+    static float sumOfSquares(const float* data, int numSamples) noexcept;
+
+    // Coeficientes de la ponderación K: shelf de agudos y pasa altos RLB (también los usa AutoGain)
+    static std::array<juce::dsp::IIR::Coefficients<float>::Ptr, 2> makeKWeightingCoefficients(double sampleRate);
+
+private:
+    // Cierra un tramo de 100 ms: actualiza momentánea, corto plazo e integrada
+    void finishLoudnessChunk() noexcept;
+
+    // Convierte energía media (suma de canales) a LUFS
+    static float energyToLufs(double energy) noexcept;
+
+    const bool measureLoudness;
+    int numPreparedChannels = 0;
+
+    // Filtros de ponderación K (shelf de agudos + pasa altos) por canal, con coeficientes compartidos
+    juce::dsp::IIR::Coefficients<float>::Ptr shelfCoefficients, highPassCoefficients;
+    std::vector<std::array<juce::dsp::IIR::Filter<float>, 2>> kWeighting;
+    juce::HeapBlock<float> weighted;  // Copia ponderada de un canal
+    int maxBlockSize = 0;
+
+    // RMS: media de cuadrados suavizada exponencialmente
+    std::array<double, maxChannels> meanSquare {};
+    double rmsTimeConstantSamples = 13230.0;
+
+    // Sonoridad: energía de tramos de 100 ms (los últimos 30 forman la ventana de 3 s)
+    static constexpr int numChunks = 30;
+    std::array<double, numChunks> chunkEnergy {};
+    int chunkIndex = 0, chunksFilled = 0;
+    double currentChunkEnergy = 0.0;
+    int currentChunkSamples = 0, chunkLength = 4800;
+
+    // Integrada: histograma de bloques de 400 ms (con 75 % de solapamiento) en pasos de 0.1 LU
+    static constexpr float histogramMinLufs = -70.0f, histogramStep = 0.1f;
+    static constexpr int histogramSize = 750;  // -70 a +5 LUFS
+    std::array<juce::uint32, histogramSize> histogramCounts {};
+    std::array<double, histogramSize> histogramEnergy {};
+
+    // Valores publicados para la interfaz
+    std::array<std::atomic<float>, maxChannels> peak, rms;
+    std::atomic<float> momentaryLufs { silenceLufs }, shortTermLufs { silenceLufs }, integratedLufs { silenceLufs };
+
+    JUCE_DECLARE_NON_COPYABLE(LevelMeter)
+};
@@ -0,0 +1,212 @@
+#include "LookaheadLimiter.h"
+
+// Calcula los coeficientes del interpolador de true peak (sinc con ventana de Hann, 8 coeficientes por fase)
+LookaheadLimiter::LookaheadLimiter()
+{
+    const double fractions[truePeakPhases] = { 0.5, 0.25, 0.75 };
+
+    for (int phase = 0; phase < truePeakPhases; ++phase)
+    {
+        const double fraction = fractions[phase];
+        double sum = 0.0;
+
+        // La historia guarda x[m-3] ... x[m+4]; la fase interpola entre x[m] y x[m+1]
+        for (int tap = 0; tap < truePeakTaps; ++tap)
+        {
+            const double t = fraction - (tap - (truePeakDelay - 1));
+            const double sinc = std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+            const double hann = 0.5 * (1.0 + std::cos(juce::MathConstants<double>::pi * t / truePeakDelay));
+
+            truePeakCoefficients[(size_t)phase][(size_t)tap] = (float)(sinc * hann);
+            sum += sinc * hann;
+        }
+
+        // Ganancia unitaria en continua
+        for (auto& c : truePeakCoefficients[(size_t)phase])
+            c = (float)(c / sum);
+    }
+}
+
+// Reserva todo para la anticipación máxima: después no se asigna memoria en el hilo de audio
+void LookaheadLimiter::prepare(double sampleRate, int maximumBlockSize, int numChannels)
+{
+    currentSampleRate = sampleRate;
+    maxLookahead = juce::roundToInt(maxLookaheadSeconds * sampleRate);
+    lookahead = juce::jmin(lookahead, maxLookahead);
+    window = lookahead + 1;
+
+    queue.resize((size_t)maxLookahead + 2);
+    boxHistory.resize((size_t)maxLookahead + 1);
+    truePeakHistory.resize((size_t)juce::jmax(0, numChannels));
+
+    const int delaySize = juce::nextPowerOfTwo(maxLookahead + truePeakDelay + 1);
+    delayBuffer.setSize(juce::jmax(0, numChannels), delaySize);
+    delayMask = delaySize - 1;
+
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+    gains.allocate((size_t)maxBlockSize, true);
+
+    reset();
+}
+
+void LookaheadLimiter::reset()
+{
+    delayBuffer.clear();
+    delayWritePosition = 0;
+
+    queueHead = queueSize = 0;
+    sampleCounter = 0;
+
+    std::fill(boxHistory.begin(), boxHistory.end(), 1.0f);
+    boxPosition = 0;
+    boxSum = (double)window;
+    releasedGain = 1.0f;
+
+    for (auto& history : truePeakHistory)
+        history.fill(0.0f);
+
+    gainReductionDecibels.store(0.0f, std::memory_order_relaxed);
+}
+
+void LookaheadLimiter::setParameters(bool shouldBeEnabled, float ceilingDecibels, float lookaheadMilliseconds,
+                                     float releaseMilliseconds, bool shouldDetectTruePeak)
+{
+    const int newLookahead = juce::jlimit(0, maxLookahead, juce::roundToInt(lookaheadMilliseconds * 0.001 * currentSampleRate));
+
+    // Cambiar la latencia (o reactivar la etapa) invalida el retardo y la ventana: se empieza de cero
+    const bool latencyChanged = newLookahead != lookahead || shouldDetectTruePeak != truePeak;
+    const bool needsReset = (shouldBeEnabled && ! enabled) || latencyChanged;
+
+    enabled = shouldBeEnabled;
+    truePeak = shouldDetectTruePeak;
+    lookahead = newLookahead;
+    window = lookahead + 1;
+    ceiling = juce::Decibels::decibelsToGain(ceilingDecibels);
+    releaseCoefficient = (float)(1.0 - std::exp(-1.0 / (juce::jmax(1.0f, releaseMilliseconds) * 0.001 * currentSampleRate)));
+
+    if (needsReset)
+        reset();
+}
+
+int LookaheadLimiter::getLatencyInSamples() const noexcept
+{
+    if (! enabled)
+        return 0;
+
+    return lookahead + (truePeak ? truePeakDelay : 0);
+}
+
+// Pico de la muestra (enlazado entre canales). En modo true peak también evalúa las fases intermedias
+// entre muestras que pida la calidad; el resultado corresponde a la muestra de hace truePeakDelay muestras.
+float LookaheadLimiter::detectPeak(const juce::AudioBuffer<float>& buffer, int sample) noexcept
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int)truePeakHistory.size());
+    float peak = 0.0f;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float x = buffer.getSample(ch, sample);
+
+        if (! truePeak)
+        {
+            peak = juce::jmax(peak, std::abs(x));
+            continue;
+        }
+
+        auto& history = truePeakHistory[(size_t)ch];
+        std::copy(history.begin() + 1, history.end(), history.begin());
+        history[truePeakTaps - 1] = x;
+
+        peak = juce::jmax(peak, std::abs(history[truePeakDelay - 1]));
+
+        for (int phase = 0; phase < phasesToEvaluate; ++phase)
+        {
+            const auto& coefficients = truePeakCoefficients[(size_t)phase];
+            float interpolated = 0.0f;
+            for (int tap = 0; tap < truePeakTaps; ++tap)
+                interpolated += coefficients[(size_t)tap] * history[(size_t)tap];
+
+            peak = juce::jmax(peak, std::abs(interpolated));
+        }
+    }
+
+    return peak;
+}
+
+// Mínimo deslizante con cola monótona: cada ganancia entra y sale una sola vez (O(1) amortizado).
+// La cola queda ordenada de menor a mayor; la cabeza es el mínimo de la ventana.
+float LookaheadLimiter::pushAndGetMinimum(float gain) noexcept
+{
+    const int capacity = (int)queue.size();
+
+    // Las ganancias mayores que la nueva ya no pueden ser el mínimo mientras esta siga en la ventana
+    while (queueSize > 0 && queue[(size_t)((queueHead + queueSize - 1) % capacity)].gain >= gain)
+        --queueSize;
+
+    queue[(size_t)((queueHead + queueSize) % capacity)] = { gain, sampleCounter };
+    ++queueSize;
+
+    // Como mucho una entrada sale de la ventana por muestra
+    if (queue[(size_t)queueHead].index <= sampleCounter - window)
+    {
+        queueHead = (queueHead + 1) % capacity;
+        --queueSize;
+    }
+
+    ++sampleCounter;
+    return queue[(size_t)queueHead].gain;
+}
+
+// Calcula la ganancia por muestra y la aplica a la señal retrasada, en trozos de como máximo maxBlockSize
+void LookaheadLimiter::process(juce::AudioBuffer<float>& buffer)
+{
+    if (! enabled || delayBuffer.getNumSamples() == 0)
+        return;
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayBuffer.getNumChannels());
+    const int totalSamples = buffer.getNumSamples();
+    const int delay = getLatencyInSamples();
+    float minimumGain = 1.0f;
+
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const int numSamples = juce::jmin(maxBlockSize, totalSamples - start);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float peak = detectPeak(buffer, start + i);
+            const float target = peak > ceiling ? ceiling / peak : 1.0f;
+
+            // El release solo frena las subidas: releasedGain nunca supera al mínimo de la ventana
+            const float held = pushAndGetMinimum(target);
+            releasedGain = held < releasedGain ? held : releasedGain + (held - releasedGain) * releaseCoefficient;
+
+            // La media móvil de "window" muestras llega a la ganancia necesaria justo cuando el pico
+            // sale del retardo, sin escalón
+            boxSum += releasedGain - boxHistory[(size_t)boxPosition];
+            boxHistory[(size_t)boxPosition] = releasedGain;
+            boxPosition = boxPosition + 1 == window ? 0 : boxPosition + 1;
+
+            gains[i] = (float)(boxSum / window);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = buffer.getWritePointer(ch, start);
+            float* delayLine = delayBuffer.getWritePointer(ch);
+            int position = delayWritePosition;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                delayLine[position] = data[i];
+                data[i] = delayLine[(position - delay) & delayMask] * gains[i];
+                position = (position + 1) & delayMask;
+            }
+        }
+
+        delayWritePosition = (delayWritePosition + numSamples) & delayMask;
+        minimumGain = juce::jmin(minimumGain, juce::FloatVectorOperations::findMinimum(gains.get(), numSamples));
+    }
+
+    gainReductionDecibels.store(juce::Decibels::gainToDecibels(minimumGain), std::memory_order_relaxed);
+}
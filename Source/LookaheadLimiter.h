@@ -0,0 +1,94 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase LookaheadLimiter: limitador con anticipación al final de la cadena.
+// La señal se retrasa "lookahead" muestras y la ganancia empieza a bajar antes de que llegue el pico:
+//   1. Detector: pico por muestra (enlazado entre canales), opcionalmente true peak (interpolado 4x)
+//   2. Mínimo deslizante de la ganancia necesaria, con una cola monótona (O(1) amortizado por muestra,
+//      sin recorrer la ventana: el coste no depende de la anticipación ni de la frecuencia de muestreo)
+//   3. Release exponencial y media móvil de la misma longitud (la ganancia llega al valor justo a tiempo)
+class LookaheadLimiter
+{
+public:
+    static constexpr double maxLookaheadSeconds = 0.02;  // Anticipación máxima (20 ms)
+
+    LookaheadLimiter();  // Constructor
+
+    // Reserva las líneas de retardo y las colas para la anticipación máxima
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+
+    // Vacía el retardo y vuelve la ganancia a 1
+    void reset();
+
+    // Cambia los parámetros; si cambia la latencia (anticipación o true peak) el estado se reinicia
+    void setParameters(bool shouldBeEnabled, float ceilingDecibels, float lookaheadMilliseconds,
+                       float releaseMilliseconds, bool shouldDetectTruePeak);
+
+    // Calidad del detector de true peak (la ajusta el gobernador de CPU): cuántas de las tres fases
+    // intermedias evalúa, empezando por la central (3 = todas, 0 = solo el pico de muestra). El detector
+    // conserva su retardo, así que la latencia no cambia
+    void setTruePeakPhases(int numPhases) noexcept { phasesToEvaluate = juce::jlimit(0, truePeakPhases, numPhases); }
+
+    // Indica si el limitador está procesando audio
+    bool isActive() const noexcept { return enabled; }
+
+    // Latencia añadida: la anticipación más el retardo del detector de true peak (0 si está desactivado)
+    int getLatencyInSamples() const noexcept;
+
+    // Reducción de ganancia actual en dB (<= 0), para la interfaz
+    float getGainReductionDecibels() const noexcept { return gainReductionDecibels.load(std::memory_order_relaxed); }
+
+    // Procesa el buffer (in-place)
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    // Pico del detector para la muestra actual (máximo entre canales)
+    float detectPeak(const juce::AudioBuffer<float>& buffer, int sample) noexcept;
+
+    // Mete una ganancia nueva en la ventana y devuelve el mínimo de las últimas "window" muestras
+    float pushAndGetMinimum(float gain) noexcept;
+
+    // Interpolador polifase para true peak: 3 fases intermedias con 8 coeficientes, guardadas en el orden
+    // 1/2, 1/4, 3/4 para que una calidad reducida evalúe primero la central
+    static constexpr int truePeakTaps = 8;
+    static constexpr int truePeakPhases = 3;
+    static constexpr int truePeakDelay = truePeakTaps / 2;  // Retardo del detector en muestras
+    std::array<std::array<float, truePeakTaps>, truePeakPhases> truePeakCoefficients {};
+
+    // Parámetros
+    bool enabled = false, truePeak = true;
+    int phasesToEvaluate = truePeakPhases;
+    float ceiling = 1.0f;
+    int lookahead = 0;         // Anticipación en muestras
+    int maxLookahead = 0;      // Anticipación máxima a la frecuencia de muestreo actual
+    int window = 1;            // lookahead + 1: longitud del mínimo deslizante y de la media móvil
+    float releaseCoefficient = 0.0f;
+    double currentSampleRate = 44100.0;
+
+    // Cola monótona (creciente) de ganancias con su índice de muestra, en un buffer circular
+    struct Entry { float gain; juce::int64 index; };
+    std::vector<Entry> queue;
+    int queueHead = 0, queueSize = 0;
+    juce::int64 sampleCounter = 0;
+
+    // Media móvil de la ganancia con release: suma acumulada y muestras de la ventana
+    std::vector<float> boxHistory;
+    int boxPosition = 0;
+    double boxSum = 0.0;
+    float releasedGain = 1.0f;
+
+    // Historia de cada canal para el interpolador de true peak
+    std::vector<std::array<float, truePeakTaps>> truePeakHistory;
+
+    // Líneas de retardo por canal (tamaño potencia de dos) y ganancia calculada para el bloque
+    juce::AudioBuffer<float> delayBuffer;
+    int delayMask = 0, delayWritePosition = 0;
+    juce::HeapBlock<float> gains;
+    int maxBlockSize = 0;
+
+    std::atomic<float> gainReductionDecibels { 0.0f };
+
+    // Evita que la clase sea copiada accidentalmente
+    JUCE_DECLARE_NON_COPYABLE(LookaheadLimiter)
+};
@@ -0,0 +1,238 @@
+#include "OutputStage.h"
+
+//==============================================================================
+// Rampa
+
+// Calcula la duración de la rampa en muestras y termina cualquier rampa pendiente
+void OutputStage::Ramp::reset(double sampleRate, double rampLengthSeconds)
+{
+    rampLength = juce::jmax(1, juce::roundToInt(sampleRate * rampLengthSeconds));
+    skip();
+}
+
+// Cambia el objetivo y calcula el incremento por muestra
+void OutputStage::Ramp::setTarget(float newTarget)
+{
+    if (newTarget == target)  // Sin cambios, no hay nada que recalcular
+        return;
+
+    target = newTarget;
+    countdown = rampLength;
+
+    if (type == Type::multiplicative)
+    {
+        // La rampa multiplicativa avanza por un factor constante (pasos iguales en dB)
+        current = juce::jmax(current, multiplicativeFloor);
+        step = std::pow(juce::jmax(target, multiplicativeFloor) / current, 1.0f / (float)rampLength);
+
+        float power = 1.0f;
+        for (auto& p : stepPowers)
+            p = (power *= step);
+    }
+    else
+    {
+        step = (target - current) / (float)rampLength;  // Incremento constante por muestra
+    }
+}
+
+// Termina la rampa y deja el valor actual en el objetivo
+void OutputStage::Ramp::skip() noexcept
+{
+    current = target;
+    countdown = 0;
+}
+
+// Genera los valores de la rampa; ambos tipos son bucles sin dependencias que el compilador vectoriza
+void OutputStage::Ramp::fill(float* dest, int numSamples) noexcept
+{
+    const int rampSamples = juce::jmin(numSamples, countdown);
+
+    if (type == Type::multiplicative)
+    {
+        // base * step^(j+1) por grupo; la única cadena de multiplicaciones es la de la base, una por grupo
+        float base = current;
+        int i = 0;
+
+        for (; i + lanes <= rampSamples; i += lanes)
+        {
+            for (int j = 0; j < lanes; ++j)
+                dest[i + j] = base * stepPowers[(size_t)j];
+
+            base = dest[i + lanes - 1];
+        }
+
+        for (int j = 0; i + j < rampSamples; ++j)
+            dest[i + j] = base * stepPowers[(size_t)j];
+
+        current = rampSamples > 0 ? dest[rampSamples - 1] : current;
+    }
+    else
+    {
+        const float start = current;
+        for (int i = 0; i < rampSamples; ++i)
+            dest[i] = start + step * (float)(i + 1);
+        current = start + step * (float)rampSamples;
+    }
+
+    countdown -= rampSamples;
+    if (countdown == 0)
+        current = target;  // Evita que el error de redondeo se acumule al final de la rampa
+
+    // El resto del bloque (si la rampa terminó) se rellena con el valor final
+    if (rampSamples < numSamples)
+        juce::FloatVectorOperations::fill(dest + rampSamples, current, numSamples - rampSamples);
+}
+
+//==============================================================================
+// OutputStage
+
+OutputStage::OutputStage()
+{
+    getPanTable();  // Fuerza la construcción de la tabla fuera del hilo de audio
+}
+
+// Construye (una sola vez) la tabla con las ganancias de cada ley de paneo
+const OutputStage::PanTable& OutputStage::getPanTable()
+{
+    static const PanTable table = []
+        {
+            PanTable t {};
+
+            for (int i = 0; i <= panTableSize; ++i)
+            {
+                const float x = (float)i / (float)panTableSize;               // Posición entre 0 (izquierda) y 1 (derecha)
+                const float pan = x * 2.0f - 1.0f;                             // Posición entre -1 y 1
+                const float angle = x * juce::MathConstants<float>::halfPi;   // Ángulo entre 0 y π/2
+
+                t[(size_t)PanLaw::constantPower][(size_t)i] = { std::cos(angle), std::sin(angle) };
+                t[(size_t)PanLaw::minus4_5dB][(size_t)i] = { std::sqrt((1.0f - x) * std::cos(angle)), std::sqrt(x * std::sin(angle)) };
+                t[(size_t)PanLaw::linear][(size_t)i] = { 1.0f - x, x };
+                t[(size_t)PanLaw::balance][(size_t)i] = { juce::jmin(1.0f, 1.0f - pan), juce::jmin(1.0f, 1.0f + pan) };
+            }
+
+            return t;
+        }();
+
+    return table;
+}
+
+// Busca en la tabla e interpola linealmente entre las dos posiciones vecinas
+std::pair<float, float> OutputStage::getPanGains(PanLaw law, float pan)
+{
+    const auto& row = getPanTable()[(size_t)law];
+
+    const float position = juce::jlimit(0.0f, (float)panTableSize, (pan + 1.0f) * 0.5f * (float)panTableSize);
+    const int index = juce::jmin((int)position, panTableSize - 1);
+    const float frac = position - (float)index;
+
+    const auto& a = row[(size_t)index];
+    const auto& b = row[(size_t)index + 1];
+
+    return { a.first + (b.first - a.first) * frac, a.second + (b.second - a.second) * frac };
+}
+
+// Reserva los buffers de rampa y configura la duración de las rampas
+void OutputStage::prepare(double sampleRate, int maximumBlockSize)
+{
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    gainBuffer.allocate((size_t)maxBlockSize, true);
+    leftBuffer.allocate((size_t)maxBlockSize, true);
+    rightBuffer.allocate((size_t)maxBlockSize, true);
+    widthBuffer.allocate((size_t)maxBlockSize, true);
+
+    for (auto* ramp : { &gainRamp, &leftRamp, &rightRamp, &widthRamp })
+        ramp->reset(sampleRate, rampSeconds);
+}
+
+// Termina todas las rampas en curso
+void OutputStage::reset()
+{
+    for (auto* ramp : { &gainRamp, &leftRamp, &rightRamp, &widthRamp })
+        ramp->skip();
+}
+
+void OutputStage::setGain(float newGain)
+{
+    gainRamp.setTarget(newGain);
+}
+
+// Convierte el pan en ganancias por canal usando la tabla (sin cos/sin por bloque)
+void OutputStage::setPan(float newPan, PanLaw newLaw)
+{
+    const auto gains = getPanGains(newLaw, newPan);
+    leftRamp.setTarget(gains.first);
+    rightRamp.setTarget(gains.second);
+}
+
+void OutputStage::setWidth(float newWidth)
+{
+    widthRamp.setTarget(newWidth);
+}
+
+// Aplica la etapa de salida en trozos de como máximo maxBlockSize muestras
+void OutputStage::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int totalSamples = buffer.getNumSamples();
+
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const int numSamples = juce::jmin(maxBlockSize, totalSamples - start);
+
+        if (numChannels >= 2)
+        {
+            float* left = buffer.getWritePointer(0, start);
+            float* right = buffer.getWritePointer(1, start);
+
+            // Ancho estéreo (codificación M/S), se omite cuando está en 1.0 y sin rampa
+            if (widthRamp.isSmoothing() || widthRamp.getCurrentValue() != 1.0f)
+            {
+                widthRamp.fill(widthBuffer, numSamples);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float mid = (left[i] + right[i]) * 0.5f;
+                    const float side = (left[i] - right[i]) * 0.5f * widthBuffer[i];
+                    left[i] = mid + side;
+                    right[i] = mid - side;
+                }
+            }
+
+            if (gainRamp.isSmoothing() || leftRamp.isSmoothing() || rightRamp.isSmoothing())
+            {
+                // Combina la rampa de ganancia con las rampas de paneo y las aplica por muestra
+                gainRamp.fill(gainBuffer, numSamples);
+                leftRamp.fill(leftBuffer, numSamples);
+                rightRamp.fill(rightBuffer, numSamples);
+
+                juce::FloatVectorOperations::multiply(leftBuffer.get(), gainBuffer.get(), numSamples);
+                juce::FloatVectorOperations::multiply(rightBuffer.get(), gainBuffer.get(), numSamples);
+                juce::FloatVectorOperations::multiply(left, leftBuffer.get(), numSamples);
+                juce::FloatVectorOperations::multiply(right, rightBuffer.get(), numSamples);
+            }
+            else
+            {
+                // Sin rampas activas: misma ganancia constante que antes
+                const float gain = gainRamp.getCurrentValue();
+                juce::FloatVectorOperations::multiply(left, gain * leftRamp.getCurrentValue(), numSamples);
+                juce::FloatVectorOperations::multiply(right, gain * rightRamp.getCurrentValue(), numSamples);
+            }
+        }
+        else if (numChannels == 1)
+        {
+            // Si es mono, solo aplica ganancia sin pan
+            float* data = buffer.getWritePointer(0, start);
+
+            if (gainRamp.isSmoothing())
+            {
+                gainRamp.fill(gainBuffer, numSamples);
+                juce::FloatVectorOperations::multiply(data, gainBuffer.get(), numSamples);
+            }
+            else
+            {
+                juce::FloatVectorOperations::multiply(data, gainRamp.getCurrentValue(), numSamples);
+            }
+        }
+    }
+}
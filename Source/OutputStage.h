@@ -0,0 +1,99 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Clase OutputStage: etapa final de ganancia, paneo y ancho estéreo con rampas por muestra
+// Sustituye a los dos applyGain constantes de processBlock para evitar el "zipper noise"
+class OutputStage
+{
+public:
+    // Leyes de paneo disponibles (el orden coincide con las opciones del parámetro "panLaw")
+    enum class PanLaw
+    {
+        constantPower = 0, // -3 dB en el centro (comportamiento original del plugin)
+        minus4_5dB,        // Compromiso entre potencia constante y lineal
+        linear,            // -6 dB en el centro
+        balance,           // Control de balance: el centro deja ambos canales a 0 dB
+        numLaws
+    };
+
+    OutputStage();  // Constructor
+
+    // Prepara la etapa (reserva los buffers de rampa según el tamaño máximo de bloque)
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    // Salta directamente a los valores objetivo, sin rampa (por ejemplo tras un reset del host)
+    void reset();
+
+    // Ganancia lineal de salida (0.0 a 1.0 en el parámetro "gain")
+    void setGain(float newGain);
+
+    // Paneo de -1.0 (izquierda) a 1.0 (derecha) con la ley de paneo indicada
+    void setPan(float newPan, PanLaw newLaw);
+
+    // Ancho estéreo: 0.0 = mono, 1.0 = sin cambio, 2.0 = doble de señal lateral
+    void setWidth(float newWidth);
+
+    // Aplica ancho, paneo y ganancia al buffer (in-place)
+    void process(juce::AudioBuffer<float>& buffer);
+
+    // Devuelve las ganancias (izquierda, derecha) de una ley de paneo para un valor de pan dado
+    static std::pair<float, float> getPanGains(PanLaw law, float pan);
+
+private:
+    // Rampa simple que genera bloques de valores interpolados hacia un objetivo
+    class Ramp
+    {
+    public:
+        enum class Type { linear, multiplicative };
+
+        explicit Ramp(Type t) : type(t) {}
+
+        // Define la duración de la rampa en muestras
+        void reset(double sampleRate, double rampLengthSeconds);
+
+        // Salta directamente al objetivo, terminando la rampa en curso
+        void skip() noexcept;
+
+        // Cambia el objetivo; la rampa arranca desde el valor actual
+        void setTarget(float newTarget);
+
+        bool isSmoothing() const noexcept { return countdown > 0; }
+        float getCurrentValue() const noexcept { return current; }
+
+        // Escribe los próximos numSamples valores de la rampa en dest
+        void fill(float* dest, int numSamples) noexcept;
+
+    private:
+        // Valor mínimo para la rampa multiplicativa (-100 dB), ya que no puede partir ni llegar a 0
+        static constexpr float multiplicativeFloor = 1.0e-5f;
+
+        // La rampa multiplicativa se genera en grupos de "lanes" muestras con las potencias step^1..step^lanes
+        // precalculadas: cada muestra del grupo es independiente y solo la base avanza entre grupos
+        static constexpr int lanes = 8;
+
+        Type type;
+        float current = 1.0f, target = 1.0f, step = 0.0f;
+        std::array<float, lanes> stepPowers {};
+        int countdown = 0, rampLength = 1;
+    };
+
+    // Tamaño de la tabla precalculada de leyes de paneo (se interpola entre posiciones)
+    static constexpr int panTableSize = 256;
+
+    // Tabla compartida por todas las instancias: [ley][posición] -> (izquierda, derecha)
+    using PanTable = std::array<std::array<std::pair<float, float>, panTableSize + 1>, (size_t)PanLaw::numLaws>;
+    static const PanTable& getPanTable();
+
+    Ramp gainRamp { Ramp::Type::multiplicative };  // Ganancia: rampa multiplicativa (lineal en dB)
+    Ramp leftRamp { Ramp::Type::linear };          // Ganancia de paneo del canal izquierdo
+    Ramp rightRamp { Ramp::Type::linear };         // Ganancia de paneo del canal derecho
+    Ramp widthRamp { Ramp::Type::linear };         // Ancho estéreo
+
+    // Buffers temporales donde se escriben las rampas antes de multiplicarlas con el audio
+    juce::HeapBlock<float> gainBuffer, leftBuffer, rightBuffer, widthBuffer;
+    int maxBlockSize = 0;
+
+    // Duración de todas las rampas (20 ms)
+    static constexpr double rampSeconds = 0.02;
+};
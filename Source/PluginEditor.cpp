@@ -11,9 +11,38 @@ Filter_FlowAudioProcessorEditor::Filter_FlowAudioProcessorEditor(Filter_FlowAudi
     highGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "highGain", highGainSlider);
     gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "gain", gainSlider);
     panAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "pan", panSlider);
+    widthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "width", widthSlider);
+
+    // El ComboBox necesita sus opciones antes de crear el attachment
+    panLawBox.addItemList(p.parameters.getParameter("panLaw")->getAllValueStrings(), 1);
+    panLawAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.parameters, "panLaw", panLawBox);
+
+    // Modo estreo y ganancias de side
+    stereoModeBox.addItemList(p.parameters.getParameter("stereoMode")->getAllValueStrings(), 1);
+    stereoModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.parameters, "stereoMode", stereoModeBox);
+    sideLowGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "sideLowGain", sideLowGainSlider);
+    sideMidGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "sideMidGain", sideMidGainSlider);
+    sideHighGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "sideHighGain", sideHighGainSlider);
+
+    // Selector de topologa de los filtros
+    topologyBox.addItemList(p.parameters.getParameter("filterTopology")->getAllValueStrings(), 1);
+    topologyAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.parameters, "filterTopology", topologyBox);
+
+    // Controles de saturacin
+    driveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "drive", driveSlider);
+    driveCurveBox.addItemList(p.parameters.getParameter("driveCurve")->getAllValueStrings(), 1);
+    driveCurveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.parameters, "driveCurve", driveCurveBox);
+    drivePositionBox.addItemList(p.parameters.getParameter("drivePosition")->getAllValueStrings(), 1);
+    drivePositionAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(p.parameters, "drivePosition", drivePositionBox);
+
+    // Limitador de salida
+    autoGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(p.parameters, "autoGain", autoGainButton);
+    limiterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(p.parameters, "limiter", limiterButton);
+    limiterCeilingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "limiterCeiling", limiterCeilingSlider);
+
     bypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.parameters, "bypass", bypassButton);
 
-    setSize(600, 400);  // Tamao inicial de la ventana del plugin
+    setSize(820, 580);  // Tamao inicial de la ventana del plugin
 
     // Cambiamos colores de los controles para mejorar la apariencia
     getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colours::orange);
@@ -32,8 +61,14 @@ Filter_FlowAudioProcessorEditor::Filter_FlowAudioProcessorEditor(Filter_FlowAudi
     setupSlider(lowGainSlider, lowGainLabel, "Low");
     setupSlider(midGainSlider, midGainLabel, "Mid");
     setupSlider(highGainSlider, highGainLabel, "High");
+    setupSlider(sideLowGainSlider, sideLowGainLabel, "S Low");
+    setupSlider(sideMidGainSlider, sideMidGainLabel, "S Mid");
+    setupSlider(sideHighGainSlider, sideHighGainLabel, "S High");
     setupSlider(gainSlider, gainLabel, "Gain");
     setupSlider(panSlider, panLabel, "Pan");
+    setupSlider(widthSlider, widthLabel, "Width");
+    setupSlider(driveSlider, driveLabel, "Drive");
+    setupSlider(limiterCeilingSlider, limiterCeilingLabel, "Ceiling");
 
     bypassButton.setButtonText("Bypass");  // Texto para el botn bypass
 
@@ -43,6 +78,10 @@ Filter_FlowAudioProcessorEditor::Filter_FlowAudioProcessorEditor(Filter_FlowAudi
     addAndMakeVisible(panSlider);
     addAndMakeVisible(gainLabel);
     addAndMakeVisible(panLabel);
+    addAndMakeVisible(widthSlider);
+    addAndMakeVisible(widthLabel);
+    addAndMakeVisible(panLawBox);
+    addAndMakeVisible(topologyBox);
 
     addAndMakeVisible(lowGainSlider);
     addAndMakeVisible(midGainSlider);
@@ -51,57 +90,119 @@ Filter_FlowAudioProcessorEditor::Filter_FlowAudioProcessorEditor(Filter_FlowAudi
     addAndMakeVisible(midGainLabel);
     addAndMakeVisible(highGainLabel);
 
-    startTimerHz(30); // Arranca un timer que llama timerCallback 30 veces por segundo para actualizar la interfaz
+    addAndMakeVisible(stereoModeBox);
+    addAndMakeVisible(sideLowGainSlider);
+    addAndMakeVisible(sideMidGainSlider);
+    addAndMakeVisible(sideHighGainSlider);
+    addAndMakeVisible(sideLowGainLabel);
+    addAndMakeVisible(sideMidGainLabel);
+    addAndMakeVisible(sideHighGainLabel);
+
+    addAndMakeVisible(driveSlider);
+    addAndMakeVisible(driveLabel);
+    addAndMakeVisible(driveCurveBox);
+    addAndMakeVisible(drivePositionBox);
+
+    addAndMakeVisible(limiterButton);
+    addAndMakeVisible(autoGainButton);
+    addAndMakeVisible(limiterCeilingSlider);
+    addAndMakeVisible(limiterCeilingLabel);
+
+    // Botn de "EQ match" y su etiqueta de estado
+    eqMatchButton.onClick = [this] { chooseEQMatchFiles(); };
+    addAndMakeVisible(eqMatchButton);
+    addAndMakeVisible(eqMatchStatus);
+    addAndMakeVisible(cpuLabel);
+
+    startTimerHz(refreshHz); // Arranca un timer que llama timerCallback 30 veces por segundo para actualizar la interfaz
 }
 
 // Destructor vaco (puede usarse para limpieza si se necesita)
 Filter_FlowAudioProcessorEditor::~Filter_FlowAudioProcessorEditor() {}
 
-// Funcin que calcula la magnitud (ganancia) de un filtro IIR a una frecuencia dada
-float Filter_FlowAudioProcessorEditor::calculateMagnitudeForFrequency(const juce::dsp::IIR::Filter<float>& filter, float sampleRate, float frequency) const
+// Mtodo para dibujar la interfaz grfica
+void Filter_FlowAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    auto coeffs = filter.coefficients;
-    if (coeffs == nullptr)  // Si el filtro no tiene coeficientes, retornamos 0
-        return 0.0f;
+    FILTER_FLOW_TRACE_SCOPE("paint");
 
-    // Calculamos la frecuencia angular normalizada
-    double w = 2.0 * juce::MathConstants<double>::pi * frequency / sampleRate;
+    g.fillAll(juce::Colour(30, 30, 30)); // Fondo gris oscuro
 
-    const auto& c = *coeffs;
+    // Toma las curvas ms nuevas que haya terminado el hilo de curvas (sin esperarlo)
+    curveBuilder.acquireLatest();
+    const auto& curves = curveBuilder.getCurves();
 
-    // Numerador de la funcin de transferencia H(z)
-    std::complex<double> numerator = std::complex<double>(
-        c.coefficients[0] + c.coefficients[1] * std::cos(-w) + c.coefficients[2] * std::cos(-2 * w),
-        c.coefficients[1] * std::sin(-w) + c.coefficients[2] * std::sin(-2 * w)
-    );
+    // Dibujamos las curvas de respuesta EQ con colores especficos para cada banda
+    g.setColour(juce::Colours::green);
+    g.strokePath(curves.bands[SimpleEQ::lowBand], juce::PathStrokeType(2.0f));
 
-    // Denominador de la funcin de transferencia H(z)
-    std::complex<double> denominator = std::complex<double>(
-        1.0 + c.coefficients[3] * std::cos(-w) + c.coefficients[4] * std::cos(-2 * w),
-        c.coefficients[3] * std::sin(-w) + c.coefficients[4] * std::sin(-2 * w)
-    );
+    g.setColour(juce::Colours::yellow);
+    g.strokePath(curves.bands[SimpleEQ::midBand], juce::PathStrokeType(2.0f));
 
-    // Transferencia H en esa frecuencia
-    std::complex<double> H = numerator / denominator;
+    g.setColour(juce::Colours::red);
+    g.strokePath(curves.bands[SimpleEQ::highBand], juce::PathStrokeType(2.0f));
 
-    // Retornamos la magnitud (valor absoluto) de H
-    return static_cast<float>(std::abs(H));
+    g.setColour(juce::Colours::skyblue);
+    g.strokePath(curves.side, juce::PathStrokeType(1.5f));
+
+    drawMeters(g);
 }
 
-// Mtodo para dibujar la interfaz grfica
-void Filter_FlowAudioProcessorEditor::paint(juce::Graphics& g)
+// Dibuja barras de pico (claro) y RMS (oscuro) por canal, de -60 a +6 dBFS, y la sonoridad de salida
+void Filter_FlowAudioProcessorEditor::drawMeters(juce::Graphics& g)
 {
-    g.fillAll(juce::Colour(30, 30, 30)); // Fondo gris oscuro
+    auto area = meterArea;
+    auto textArea = area.removeFromBottom(80);
+    auto labelArea = area.removeFromTop(16);
 
-    // Dibujamos las curvas de respuesta EQ con colores especficos para cada banda
-    g.setColour(juce::Colours::green);
-    g.strokePath(lowBandPath, juce::PathStrokeType(2.0f));
+    auto levelToY = [&area](float level)
+        {
+            const float dB = juce::jlimit(-60.0f, 6.0f, juce::Decibels::gainToDecibels(level, -60.0f));
+            return juce::jmap(dB, -60.0f, 6.0f, (float)area.getBottom(), (float)area.getY());
+        };
 
-    g.setColour(juce::Colours::yellow);
-    g.strokePath(midBandPath, juce::PathStrokeType(2.0f));
+    auto drawPair = [&](juce::Rectangle<int> pairArea, const LevelMeter& meter, const std::array<float, LevelMeter::maxChannels>& peaks)
+        {
+            const int barWidth = pairArea.getWidth() / LevelMeter::maxChannels;
 
-    g.setColour(juce::Colours::red);
-    g.strokePath(highBandPath, juce::PathStrokeType(2.0f));
+            for (int ch = 0; ch < LevelMeter::maxChannels; ++ch)
+            {
+                auto bar = pairArea.removeFromLeft(barWidth).reduced(2, 0).toFloat();
+
+                g.setColour(juce::Colour(50, 50, 50));
+                g.fillRect(bar);
+
+                g.setColour(peaks[(size_t)ch] > 1.0f ? juce::Colours::red : juce::Colours::limegreen);
+                g.fillRect(bar.withTop(levelToY(peaks[(size_t)ch])));
+
+                g.setColour(juce::Colours::darkgreen);
+                g.fillRect(bar.withTop(levelToY(meter.getRms(ch))));
+            }
+        };
+
+    const int half = area.getWidth() / 2;
+    drawPair(area.removeFromLeft(half), audioProcessor.inputMeter, inputPeakDisplay);
+    drawPair(area, audioProcessor.outputMeter, outputPeakDisplay);
+
+    g.setColour(juce::Colours::lightgrey);
+    g.setFont(12.0f);
+    g.drawText("In", labelArea.removeFromLeft(half), juce::Justification::centred);
+    g.drawText("Out", labelArea, juce::Justification::centred);
+
+    // Sonoridad de salida (BS.1770): momentnea, corto plazo e integrada
+    auto lufsText = [](float lufs)
+        {
+            return lufs <= LevelMeter::silenceLufs ? juce::String("-inf") : juce::String(lufs, 1);
+        };
+
+    const auto& out = audioProcessor.outputMeter;
+    g.drawText("M " + lufsText(out.getMomentaryLoudness()) + " LUFS", textArea.removeFromTop(20), juce::Justification::centredLeft);
+    g.drawText("S " + lufsText(out.getShortTermLoudness()) + " LUFS", textArea.removeFromTop(20), juce::Justification::centredLeft);
+    g.drawText("I " + lufsText(out.getIntegratedLoudness()) + " LUFS", textArea.removeFromTop(20), juce::Justification::centredLeft);
+
+    // Reduccin de ganancia del limitador
+    if (audioProcessor.limiter.isActive())
+        g.drawText("GR " + juce::String(audioProcessor.limiter.getGainReductionDecibels(), 1) + " dB",
+                   textArea.removeFromTop(20), juce::Justification::centredLeft);
 }
 
 // Mtodo que ajusta el tamao y posicin de los controles cuando se redimensiona la ventana
@@ -110,7 +211,18 @@ void Filter_FlowAudioProcessorEditor::resized()
     auto area = getLocalBounds().reduced(20);
 
     // Posiciona el botn bypass en la parte inferior izquierda
-    bypassButton.setBounds(area.removeFromBottom(30).removeFromLeft(100));
+    auto bottomRow = area.removeFromBottom(30);
+    bypassButton.setBounds(bottomRow.removeFromLeft(100));
+
+    // "EQ match" a la derecha del bypass
+    eqMatchButton.setBounds(bottomRow.removeFromLeft(110).reduced(2));
+    limiterButton.setBounds(bottomRow.removeFromLeft(100).reduced(4, 0));
+    autoGainButton.setBounds(bottomRow.removeFromLeft(100).reduced(4, 0));
+    cpuLabel.setBounds(bottomRow.removeFromRight(meterWidth + 40));
+    eqMatchStatus.setBounds(bottomRow.reduced(4, 0));
+
+    // Medidores a la derecha, a toda la altura
+    meterArea = area.removeFromRight(meterWidth).reduced(4, 0);
 
     // rea para el visualizador EQ (arriba)
     auto visualizerArea = area.removeFromTop(150);
@@ -120,68 +232,108 @@ void Filter_FlowAudioProcessorEditor::resized()
     auto controlWidth = 100;
     gainSlider.setBounds(topRow.removeFromLeft(controlWidth).reduced(10));
     panSlider.setBounds(topRow.removeFromLeft(controlWidth).reduced(10));
+    widthSlider.setBounds(topRow.removeFromLeft(controlWidth).reduced(10));
+    panLawBox.setBounds(topRow.removeFromLeft(160).withSizeKeepingCentre(150, 24));
+    topologyBox.setBounds(topRow.removeFromLeft(160).withSizeKeepingCentre(150, 24));
 
     // Segunda fila: sliders Low, Mid, High
     auto eqRow = area.removeFromTop(150);
     lowGainSlider.setBounds(eqRow.removeFromLeft(controlWidth).reduced(10));
     midGainSlider.setBounds(eqRow.removeFromLeft(controlWidth).reduced(10));
     highGainSlider.setBounds(eqRow.removeFromLeft(controlWidth).reduced(10));
+
+    // Saturacin a la derecha de las bandas: slider de drive y selectores apilados
+    driveSlider.setBounds(eqRow.removeFromLeft(controlWidth).reduced(10));
+    auto driveBoxes = eqRow.removeFromLeft(160).withSizeKeepingCentre(150, 60);
+    driveCurveBox.setBounds(driveBoxes.removeFromTop(24));
+    drivePositionBox.setBounds(driveBoxes.removeFromBottom(24));
+
+    // Techo del limitador
+    limiterCeilingSlider.setBounds(eqRow.removeFromLeft(controlWidth).reduced(10));
+
+    // Tercera fila: ganancias de side y selector de modo estreo
+    auto sideRow = area.removeFromTop(100);
+    sideLowGainSlider.setBounds(sideRow.removeFromLeft(controlWidth).reduced(10));
+    sideMidGainSlider.setBounds(sideRow.removeFromLeft(controlWidth).reduced(10));
+    sideHighGainSlider.setBounds(sideRow.removeFromLeft(controlWidth).reduced(10));
+    stereoModeBox.setBounds(sideRow.removeFromLeft(160).withSizeKeepingCentre(150, 24));
 }
 
-// Mtodo llamado peridicamente por el timer para actualizar la visualizacin
-void Filter_FlowAudioProcessorEditor::timerCallback()
+// Pide el archivo de referencia y despus el objetivo; con ambos lanza el anlisis en el procesador
+void Filter_FlowAudioProcessorEditor::chooseEQMatchFiles()
 {
-    updateEQVisualization(); // Actualiza las curvas de la EQ
-    repaint();               // Fuerza que se repinte la interfaz
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    const juce::String patterns = "*.wav;*.aif;*.aiff;*.flac;*.ogg";
+
+    fileChooser = std::make_unique<juce::FileChooser>("Archivo de referencia", juce::File(), patterns);
+    fileChooser->launchAsync(flags, [this, flags, patterns](const juce::FileChooser& referenceChooser)
+        {
+            eqMatchReference = referenceChooser.getResult();
+            if (eqMatchReference == juce::File())
+                return;
+
+            fileChooser = std::make_unique<juce::FileChooser>("Archivo a igualar", eqMatchReference.getParentDirectory(), patterns);
+            fileChooser->launchAsync(flags, [this](const juce::FileChooser& targetChooser)
+                {
+                    const auto target = targetChooser.getResult();
+                    if (target != juce::File())
+                        audioProcessor.startEQMatch(eqMatchReference, target);
+                });
+        });
 }
 
-// Calcula y genera las curvas de respuesta para cada banda del EQ
-void Filter_FlowAudioProcessorEditor::updateEQVisualization()
+// Mtodo llamado peridicamente por el timer para actualizar la visualizacin
+void Filter_FlowAudioProcessorEditor::timerCallback()
 {
-    auto bounds = getLocalBounds().reduced(20).removeFromTop(200);
-    auto width = bounds.getWidth();
+    // Estado del "EQ match" (el anlisis sigue aunque se cierre el editor)
+    eqMatchStatus.setText(audioProcessor.getLastEQMatchMessage(), juce::dontSendNotification);
+    eqMatchButton.setEnabled(! audioProcessor.isEQMatchRunning());
 
-    // Limpiamos las rutas antes de dibujar
-    lowBandPath.clear();
-    midBandPath.clear();
-    highBandPath.clear();
+    // Nivel del gobernador de CPU; en los niveles bajos la interfaz tambin refresca menos
+    const auto& quality = CpuGovernor::getSettings(audioProcessor.cpuGovernor.getTier());
+    cpuLabel.setText(juce::String("CPU: ") + quality.name + " (" + juce::String(juce::roundToInt(audioProcessor.cpuGovernor.getLoad() * 100.0f)) + " %)",
+                     juce::dontSendNotification);
 
-    const int numPoints = width; // Nmero de puntos a calcular para las curvas
-    float sampleRate = audioProcessor.getSampleRate();
+    if (quality.editorRefreshHz != refreshHz)
+    {
+        refreshHz = quality.editorRefreshHz;
+        startTimerHz(refreshHz);
+    }
 
-    // Recorremos cada punto para calcular la respuesta en frecuencia logartmica
-    for (int i = 0; i < numPoints; ++i)
+    // Picos de los medidores: se toma el mximo desde el ltimo tick y se deja caer ~20 dB/s
+    const float decay = juce::Decibels::decibelsToGain(-20.0f / (float)refreshHz);
+    for (int ch = 0; ch < LevelMeter::maxChannels; ++ch)
     {
-        // Frecuencia en escala logartmica desde 20 Hz a 20 kHz aproximadamente
-        float freq = 20.0f * static_cast<float>(std::pow(10.0f, 3.0f * i / (numPoints - 1)));
+        inputPeakDisplay[(size_t)ch] = juce::jmax(audioProcessor.inputMeter.getAndResetPeak(ch), inputPeakDisplay[(size_t)ch] * decay);
+        outputPeakDisplay[(size_t)ch] = juce::jmax(audioProcessor.outputMeter.getAndResetPeak(ch), outputPeakDisplay[(size_t)ch] * decay);
+    }
 
-        // Calculamos la magnitud para cada filtro (Low, Mid, High)
-        float magLow = calculateMagnitudeForFrequency(audioProcessor.eq.getLowFilter(), sampleRate, freq);
-        float magMid = calculateMagnitudeForFrequency(audioProcessor.eq.getMidFilter(), sampleRate, freq);
-        float magHigh = calculateMagnitudeForFrequency(audioProcessor.eq.getHighFilter(), sampleRate, freq);
+    // Las ganancias de side solo suenan en modo M/S
+    const bool midSide = stereoModeBox.getSelectedItemIndex() == (int)SimpleEQ::StereoMode::midSide;
+    sideLowGainSlider.setEnabled(midSide);
+    sideMidGainSlider.setEnabled(midSide);
+    sideHighGainSlider.setEnabled(midSide);
 
-        // Funcin para mapear la ganancia (dB) a coordenadas Y en pantalla
-        auto mapToY = [&](float mag)
-            {
-                float dB = juce::Decibels::gainToDecibels(mag);
-                // Mapea de -24 dB a +24 dB en la altura del rea de dibujo
-                return juce::jmap(dB, -24.0f, 24.0f, (float)bounds.getBottom(), (float)bounds.getY());
-            };
-
-        float x = bounds.getX() + (float)i; // Posicin X en pxeles
+    updateEQVisualization(); // Actualiza las curvas de la EQ
+    repaint();               // Fuerza que se repinte la interfaz
+}
 
-        // Para el primer punto empezamos una nueva subruta, para el resto conectamos lnea
-        if (i == 0)
-        {
-            lowBandPath.startNewSubPath(x, mapToY(magLow));
-            midBandPath.startNewSubPath(x, mapToY(magMid));
-            highBandPath.startNewSubPath(x, mapToY(magHigh));
-        }
-        else
-        {
-            lowBandPath.lineTo(x, mapToY(magLow));
-            midBandPath.lineTo(x, mapToY(magMid));
-            highBandPath.lineTo(x, mapToY(magHigh));
-        }
+// Arma la foto de lo que se dibuja y la pasa al hilo de curvas (que solo trabaja si cambi algo)
+void Filter_FlowAudioProcessorEditor::updateEQVisualization()
+{
+    ResponseCurveBuilder::Snapshot snapshot;
+    snapshot.bounds = getLocalBounds().reduced(20).withTrimmedRight(meterWidth).removeFromTop(200).toFloat();
+    snapshot.sampleRate = audioProcessor.getSampleRate();
+    snapshot.midSide = stereoModeBox.getSelectedItemIndex() == (int)SimpleEQ::StereoMode::midSide;
+
+    // Ganancias actuales de cada banda (atmicas: no se leen los filtros del hilo de audio)
+    // Ganancia esttica ms el ajuste dinmico actual (0 en las bandas no dinmicas, y solo en mid)
+    const auto& eq = audioProcessor.eq;
+    for (int band = 0; band < SimpleEQ::numBands; ++band)
+    {
+        snapshot.gainsDecibels[SimpleEQ::midComponent][(size_t)band] = eq.getGainDecibels(band) + eq.getDynamicGainDecibels(band);
+        snapshot.gainsDecibels[SimpleEQ::sideComponent][(size_t)band] = eq.getGainDecibels(band, SimpleEQ::sideComponent);
     }
+
+    curveBuilder.post(snapshot);
 }
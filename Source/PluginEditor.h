@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>  // Incluye la librería JUCE principal
 #include "PluginProcessor.h"  // Incluye la definición del procesador de audio
+#include "ResponseCurveBuilder.h" // Curvas de respuesta calculadas fuera del hilo de mensajes
 
 // Clase que maneja la interfaz gráfica (GUI) del plugin
 // Hereda de AudioProcessorEditor para poder mostrar controles y gráficos
@@ -23,16 +24,15 @@ public:
     void resized() override;
 
 private:
-    // Función auxiliar para calcular la magnitud (ganancia) de un filtro IIR a una frecuencia dada
-    float calculateMagnitudeForFrequency(const juce::dsp::IIR::Filter<float>& filter,
-        float sampleRate, float frequency) const;
-
     // Método que se llama periódicamente por el Timer para actualizar la visualización de la EQ
     void timerCallback() override;
 
-    // Método propio que actualiza las curvas visuales de la EQ en la interfaz
+    // Publica las ganancias actuales para que el hilo de curvas recalcule (solo si cambiaron)
     void updateEQVisualization();
 
+    // Dibuja los medidores de entrada/salida (pico, RMS) y la sonoridad de salida
+    void drawMeters(juce::Graphics& g);
+
     Filter_FlowAudioProcessor& audioProcessor;  // Referencia al procesador para acceder a sus datos y parámetros
 
     // Controles (sliders y etiquetas) para controlar Ganancia (Gain) y Pan (balance estéreo)
@@ -49,6 +49,13 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> panAttachment;
 
+    // Control de ancho estéreo y selector de ley de paneo de la etapa de salida
+    juce::Slider widthSlider;
+    juce::Label widthLabel;
+    juce::ComboBox panLawBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> widthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> panLawAttachment;
+
     // Controles para las ganancias del ecualizador: Low, Mid y High
     juce::Slider lowGainSlider;
     juce::Slider midGainSlider;
@@ -63,8 +70,55 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midGainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highGainAttachment;
 
-    // Objetos Path para dibujar las curvas de respuesta en la interfaz gráfica de cada banda del EQ
-    juce::Path lowBandPath, midBandPath, highBandPath;
+    // Modo estéreo (L/R o M/S) y ganancias de la componente side (activas solo en M/S)
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoModeAttachment;
+    juce::Slider sideLowGainSlider, sideMidGainSlider, sideHighGainSlider;
+    juce::Label sideLowGainLabel, sideMidGainLabel, sideHighGainLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sideLowGainAttachment, sideMidGainAttachment, sideHighGainAttachment;
+
+    // Controles de la etapa de saturación: cantidad de drive, curva y posición (antes/después de la EQ)
+    juce::Slider driveSlider;
+    juce::Label driveLabel;
+    juce::ComboBox driveCurveBox;
+    juce::ComboBox drivePositionBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> driveAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> driveCurveAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> drivePositionAttachment;
+
+    // Compensación automática de ganancia
+    juce::ToggleButton autoGainButton { "Auto Gain" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> autoGainAttachment;
+
+    // Limitador de salida: activación y techo (el resto de parámetros se automatiza desde el host)
+    juce::ToggleButton limiterButton { "Limiter" };
+    juce::Slider limiterCeilingSlider;
+    juce::Label limiterCeilingLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> limiterCeilingAttachment;
+
+    // Selector de topología de los filtros (Biquad / SVF)
+    juce::ComboBox topologyBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> topologyAttachment;
+
+    // "EQ match": botón que pide los archivos de referencia y objetivo, y etiqueta con el estado
+    void chooseEQMatchFiles();
+    juce::TextButton eqMatchButton { "EQ Match..." };
+    juce::Label eqMatchStatus;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    juce::File eqMatchReference;
+
+    // Nivel de calidad del gobernador de CPU y carga actual
+    juce::Label cpuLabel;
+    int refreshHz = 30;
+
+    // Medidores: zona reservada a la derecha y pico mostrado (con caída) de cada canal
+    static constexpr int meterWidth = 100;
+    juce::Rectangle<int> meterArea;
+    std::array<float, LevelMeter::maxChannels> inputPeakDisplay {}, outputPeakDisplay {};
+
+    // Curvas de respuesta de cada banda (y de side en M/S), armadas en un hilo propio; paint() solo las dibuja
+    ResponseCurveBuilder curveBuilder;
 
     // Macro de JUCE para evitar copiar esta clase y para activar la detección de fugas de memoria (debug)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Filter_FlowAudioProcessorEditor)
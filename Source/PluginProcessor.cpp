@@ -7,6 +7,7 @@ Filter_FlowAudioProcessor::Filter_FlowAudioProcessor()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
         .withInput("Input", juce::AudioChannelSet::stereo(), true)  // Entrada estéreo si no es synth ni midi effect
+        .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)  // Señal de control opcional de las bandas dinámicas
 #endif
         .withOutput("Output", juce::AudioChannelSet::stereo(), true) // Salida estéreo obligatoria
 #endif
@@ -21,20 +22,121 @@ Filter_FlowAudioProcessor::Filter_FlowAudioProcessor()
     // Parámetro "pan" rango -1.0 (izquierda) a 1.0 (derecha), valor por defecto 0.0 (centro)
     parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("pan", "Pan", -1.0f, 1.0f, 0.0f));
 
+    // Ley de paneo usada por "pan" (por defecto potencia constante, como antes)
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("panLaw", "Pan Law",
+        juce::StringArray { "Constant Power (-3 dB)", "-4.5 dB", "Linear (-6 dB)", "Balance" }, 0));
+
+    // Ancho estéreo: 0.0 = mono, 1.0 = sin cambio, 2.0 = máximo ancho
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("width", "Width", 0.0f, 2.0f, 1.0f));
+
     // Parámetro booleano "bypass" para activar o desactivar el efecto
     parameters.createAndAddParameter(std::make_unique<juce::AudioParameterBool>("bypass", "Bypass", false));
 
+    // Compensación automática de ganancia según la respuesta de la EQ
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterBool>("autoGain", "Auto Gain", false));
+
     // Parámetros de ganancia para las tres bandas del ecualizador (low, mid, high)
     parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("lowGain", "Low Gain", -24.0f, 24.0f, 0.0f));
     parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("midGain", "Mid Gain", -24.0f, 24.0f, 0.0f));
     parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("highGain", "High Gain", -24.0f, 24.0f, 0.0f));
 
+    // Modo estéreo: en "Mid/Side" las ganancias de arriba actúan sobre mid y estas sobre side
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("stereoMode", "Stereo Mode",
+        juce::StringArray { "Stereo (L/R)", "Mid/Side" }, 0));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("sideLowGain", "Side Low Gain", -24.0f, 24.0f, 0.0f));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("sideMidGain", "Side Mid Gain", -24.0f, 24.0f, 0.0f));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("sideHighGain", "Side High Gain", -24.0f, 24.0f, 0.0f));
+
+    // Bandas dinámicas: cada banda puede bajar su ganancia según la envolvente de la señal de control
+    const std::pair<const char*, const char*> dynamicBands[SimpleEQ::numBands] = { { "low", "Low" }, { "mid", "Mid" }, { "high", "High" } };
+    for (int band = 0; band < SimpleEQ::numBands; ++band)
+    {
+        const juce::String prefix(dynamicBands[band].first), label(dynamicBands[band].second);
+        parameters.createAndAddParameter(std::make_unique<juce::AudioParameterBool>(prefix + "Dynamic", label + " Dynamic", false));
+        parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>(prefix + "Threshold", label + " Threshold", -60.0f, 0.0f, -20.0f));
+        parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>(prefix + "Ratio", label + " Ratio",
+            juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 0.4f), 2.0f));
+        parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>(prefix + "Attack", label + " Attack",
+            juce::NormalisableRange<float>(0.1f, 200.0f, 0.1f, 0.4f), 10.0f));
+        parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>(prefix + "Release", label + " Release",
+            juce::NormalisableRange<float>(5.0f, 2000.0f, 1.0f, 0.4f), 150.0f));
+
+        // Guarda los punteros para no buscar (ni construir) los IDs en cada bloque
+        dynamicParameters[(size_t)band] = { parameters.getRawParameterValue(prefix + "Dynamic"),
+                                            parameters.getRawParameterValue(prefix + "Threshold"),
+                                            parameters.getRawParameterValue(prefix + "Ratio"),
+                                            parameters.getRawParameterValue(prefix + "Attack"),
+                                            parameters.getRawParameterValue(prefix + "Release") };
+    }
+
+    // Señal de control de las bandas dinámicas: la propia entrada o el bus sidechain
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("dynamicKey", "Dynamic Key",
+        juce::StringArray { "Input", "Sidechain" }, 0));
+
+    // Topología de los filtros: biquad RBJ (original) o SVF, estable bajo automatización rápida
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("filterTopology", "Filter Topology",
+        juce::StringArray { "Biquad (RBJ)", "SVF (TPT)" }, 0));
+
+    // Parámetros de la etapa de saturación: curva ("Off" la desactiva), cantidad de drive y posición
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("driveCurve", "Drive Curve",
+        juce::StringArray { "Off", "Cubic", "Tanh", "Asymmetric" }, 0));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("drive", "Drive", 0.0f, 24.0f, 0.0f));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("drivePosition", "Drive Position",
+        juce::StringArray { "Pre EQ", "Post EQ" }, 1));
+
+    // Limitador con anticipación al final de la cadena (desactivado por defecto: no añade latencia)
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterBool>("limiter", "Limiter", false));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("limiterCeiling", "Limiter Ceiling", -12.0f, 0.0f, -1.0f));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("limiterLookahead", "Limiter Lookahead",
+        juce::NormalisableRange<float>(0.5f, (float)(LookaheadLimiter::maxLookaheadSeconds * 1000.0), 0.1f), 5.0f));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterFloat>("limiterRelease", "Limiter Release",
+        juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f, 0.4f), 100.0f));
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterBool>("limiterTruePeak", "Limiter True Peak", true));
+
+    // Gobernador de CPU: baja la calidad si el procesamiento no llega a tiempo real de forma repetida
+    parameters.createAndAddParameter(std::make_unique<juce::AudioParameterBool>("cpuGovernor", "CPU Governor", true));
+
     // Inicializa el ValueTree que guarda el estado de los parámetros
     parameters.state = juce::ValueTree("savedParams");
+
+    // Registra la instancia en el grabador de trazas (graba solo si FILTER_FLOW_TRACE está definida)
+    TraceRecorder::getInstance().addUser();
+
+    // Revisa las ganancias de la EQ 10 veces por segundo para recalcular la compensación (si cambiaron)
+    startTimerHz(10);
+}
+
+// Destructor: la última instancia detiene la grabación de trazas
+Filter_FlowAudioProcessor::~Filter_FlowAudioProcessor()
+{
+    stopTimer();
+    TraceRecorder::getInstance().removeUser();
 }
 
-// Destructor vacío porque no hay manejo manual de memoria necesario
-Filter_FlowAudioProcessor::~Filter_FlowAudioProcessor() {}
+// Hilo de mensajes: la compensación solo se recalcula cuando cambian las ganancias o la frecuencia de muestreo
+void Filter_FlowAudioProcessor::timerCallback()
+{
+    const bool midSide = (int)*parameters.getRawParameterValue("stereoMode") == (int)SimpleEQ::StereoMode::midSide;
+
+    // Solo ganancias estáticas: el ajuste de las bandas dinámicas sigue a la envolvente y una compensación
+    // recalculada a 10 Hz llegaría tarde, bombearía y desharía parte de la reducción. En L/R side no cuenta
+    AutoGain::Input input;
+    for (int band = 0; band < SimpleEQ::numBands; ++band)
+    {
+        input.gainsDecibels[SimpleEQ::midComponent][(size_t)band] = eq.getGainDecibels(band);
+        input.gainsDecibels[SimpleEQ::sideComponent][(size_t)band] = eq.getGainDecibels(band, SimpleEQ::sideComponent);
+    }
+    input.sideShare = midSide ? autoGain.getSideShare() : 0.0f;
+
+    autoGain.update(input, getSampleRate());
+}
+
+// Reproducción de capturas: el timer deja de recalcular y manda el valor grabado
+void Filter_FlowAudioProcessor::setRecordedAutoGainCompensation(float gain)
+{
+    stopTimer();
+    autoGain.setCompensationGain(gain);
+}
 
 // Devuelve el nombre del plugin definido en las macros del proyecto
 const juce::String Filter_FlowAudioProcessor::getName() const {
@@ -59,6 +161,10 @@ void Filter_FlowAudioProcessor::changeProgramName(int, const juce::String&) {}
 // Se prepara el DSP antes de empezar a procesar audio
 void Filter_FlowAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    // Selecciona la topología antes de preparar, para que los coeficientes se calculen una sola vez
+    eq.setTopology(static_cast<SimpleEQ::Topology>((int)*parameters.getRawParameterValue("filterTopology")));
+    eq.setStereoMode(static_cast<SimpleEQ::StereoMode>((int)*parameters.getRawParameterValue("stereoMode")));
+
     // Define las especificaciones para el procesamiento DSP
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;                              // Frecuencia de muestreo
@@ -68,51 +174,258 @@ void Filter_FlowAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     DBG("prepareToPlay - numChannels = " << spec.numChannels); // Debug: muestra número de canales
 
     eq.prepare(spec); // Prepara el ecualizador con estas especificaciones
+    updateDynamics(); // Configura las bandas dinámicas
+
+    // Prepara los medidores de entrada y salida
+    inputMeter.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
+    outputMeter.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+    // Captura de automatización para Tools/AutomationReplay (solo si FILTER_FLOW_CAPTURE está definida)
+    automationRecorder.prepare(sampleRate, samplesPerBlock);
+
+    // El gobernador arranca en calidad máxima con la nueva frecuencia de muestreo
+    cpuGovernor.prepare(sampleRate);
+    applyQualityTier();
+
+    updateDrive();    // Configura la saturación
+
+    // Prepara el limitador y reporta al host la latencia total (sobremuestreo + anticipación)
+    limiter.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+
+    // Retardo de la señal seca del bypass: anticipación máxima del limitador más margen para el
+    // detector de true peak y el sobremuestreo de la saturación
+    bypassStage.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(),
+                        juce::roundToInt(LookaheadLimiter::maxLookaheadSeconds * sampleRate) + maxExtraLatency);
+    bypassStage.setBypassed(*parameters.getRawParameterValue("bypass") > 0.5f);
+    bypassStage.reset();
+
+    updateLimiter();
+    updateLatency();
+
+    // Prepara la etapa de salida y arranca directamente en los valores actuales (sin rampa inicial)
+    outputStage.prepare(sampleRate, samplesPerBlock);
+    updateOutputStage();
+    outputStage.reset();
+}
+
+// Aplica a la EQ los ajustes del nivel de calidad que eligió el gobernador de CPU
+void Filter_FlowAudioProcessor::applyQualityTier()
+{
+    // En render offline no hay plazo que cumplir: siempre calidad máxima
+    cpuGovernor.setEnabled(*parameters.getRawParameterValue("cpuGovernor") > 0.5f && ! isNonRealtime());
+
+    const auto& settings = CpuGovernor::getSettings(cpuGovernor.getTier());
+    eq.setSmoothingInterval(settings.smoothingInterval);
+    eq.setDynamicRampStep(settings.dynamicRampStep);
+    limiter.setTruePeakPhases(settings.truePeakPhases);
+
+    // Al apagar el medidor de entrada se vacía, para que la interfaz no muestre un valor congelado
+    if (measureInput && ! settings.measureInput)
+        inputMeter.reset();
+
+    measureInput = settings.measureInput;
+}
+
+// Pasa los parámetros de las bandas dinámicas al ecualizador
+void Filter_FlowAudioProcessor::updateDynamics()
+{
+    for (int band = 0; band < SimpleEQ::numBands; ++band)
+    {
+        const auto& values = dynamicParameters[(size_t)band];
+
+        DynamicBandDetector::Settings settings;
+        settings.enabled = *values.enabled > 0.5f;
+        settings.thresholdDecibels = *values.threshold;
+        settings.ratio = *values.ratio;
+        settings.attackMilliseconds = *values.attack;
+        settings.releaseMilliseconds = *values.release;
+
+        eq.setDynamics(band, settings);
+    }
+}
+
+// Pasa los parámetros de saturación al ecualizador
+void Filter_FlowAudioProcessor::updateDrive()
+{
+    const int curve = (int)*parameters.getRawParameterValue("driveCurve");
+    const float drive = *parameters.getRawParameterValue("drive");
+    const bool beforeFilters = (int)*parameters.getRawParameterValue("drivePosition") == 0;
+
+    eq.setDrive(static_cast<DriveStage::Curve>(curve), drive, beforeFilters);
+}
+
+// Pasa los parámetros del limitador
+void Filter_FlowAudioProcessor::updateLimiter()
+{
+    limiter.setParameters(*parameters.getRawParameterValue("limiter") > 0.5f,
+                          *parameters.getRawParameterValue("limiterCeiling"),
+                          *parameters.getRawParameterValue("limiterLookahead"),
+                          *parameters.getRawParameterValue("limiterRelease"),
+                          *parameters.getRawParameterValue("limiterTruePeak") > 0.5f);
+}
+
+// Reporta al host la latencia total si cambió: el sobremuestreo solo cuenta con la saturación activa
+// y la anticipación solo con el limitador activo
+void Filter_FlowAudioProcessor::updateLatency()
+{
+    const int latency = eq.getLatencyInSamples() + limiter.getLatencyInSamples();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    bypassStage.setLatency(latency);  // La señal seca se retrasa lo mismo que la procesada
+}
+
+// Pasa los valores actuales de ganancia, paneo y ancho a la etapa de salida
+void Filter_FlowAudioProcessor::updateOutputStage()
+{
+    float gain = *parameters.getRawParameterValue("gain");
+
+    // La compensación se aplica a través de la rampa de ganancia, sin coste extra por muestra
+    if (*parameters.getRawParameterValue("autoGain") > 0.5f)
+        gain *= autoGain.getCompensationGain();
+    const float pan = *parameters.getRawParameterValue("pan");
+    const float width = *parameters.getRawParameterValue("width");
+    const int panLaw = (int)*parameters.getRawParameterValue("panLaw");
+
+    outputStage.setGain(gain);
+    outputStage.setPan(pan, static_cast<OutputStage::PanLaw>(panLaw));
+    outputStage.setWidth(width);
 }
 
 // Método vacío para liberar recursos, no se usa aquí
 void Filter_FlowAudioProcessor::releaseResources() {}
 
 // Método principal que procesa el audio en cada bloque
-void Filter_FlowAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void Filter_FlowAudioProcessor::processBlock(juce::AudioBuffer<float>& hostBuffer, juce::MidiBuffer&)
 {
-    // Verifica si está activo el bypass (si es así, no procesa nada)
-    const bool isBypassed = *parameters.getRawParameterValue("bypass");
-    if (isBypassed)
-        return;
+    processChain(hostBuffer, false);
+}
 
-    // Obtiene el valor de ganancia y pan de los parámetros
-    const float gain = *parameters.getRawParameterValue("gain");
-    const float pan = *parameters.getRawParameterValue("pan");
+// El host pide bypass sin pasar por el parámetro: mismo camino, con el mismo fundido y retardo
+void Filter_FlowAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& hostBuffer, juce::MidiBuffer&)
+{
+    processChain(hostBuffer, true);
+}
+
+// Parámetro que los hosts usan como su propio bypass (así no procesan el plugin dos veces)
+juce::AudioProcessorParameter* Filter_FlowAudioProcessor::getBypassParameter() const
+{
+    return parameters.getParameter("bypass");
+}
+
+// Cadena completa: medición, bypass con fundido, EQ, etapa de salida y limitador
+void Filter_FlowAudioProcessor::processChain(juce::AudioBuffer<float>& hostBuffer, bool hostBypassed)
+{
+    FILTER_FLOW_TRACE_SCOPE("processBlock");
+
+    // Se procesa solo el bus principal; el sidechain (si el host lo conecta) solo se escucha
+    auto buffer = getBusBuffer(hostBuffer, false, 0);
+    const auto sidechain = getBusBuffer(hostBuffer, true, 1);
+
+    // Mide el bloque completo para el gobernador de CPU
+    const CpuGovernor::ScopedMeasurement cpuMeasurement(cpuGovernor, buffer.getNumSamples());
+
+    // Registra el tamaño del bloque, los parámetros que cambiaron, el bypass del host y la compensación de auto gain
+    automationRecorder.captureBlock(buffer.getNumSamples(), hostBypassed, autoGain.getCompensationGain());
+
+    applyQualityTier(); // Ajustes del nivel de calidad que eligió el gobernador de CPU
+
+    if (measureInput)
+        inputMeter.process(buffer); // Mide la señal de entrada
+
+    // La latencia se calcula y se reporta en cada bloque, también en bypass: así los cambios de drive o
+    // del limitador hechos durante el bypass llegan al host, y la señal seca (y la espera al salir del
+    // bypass) usan siempre la latencia vigente
+    updateDrive();      // Actualiza la saturación (curva, drive y posición)
+    updateLimiter();
+    updateLatency();
 
-    // Obtiene número de canales y muestras del buffer de audio
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
+    // La entrada entra siempre en el retardo de la señal seca. En bypass estable solo se copia ese
+    // retardo a la salida (misma latencia que con la cadena activa, sin coste de DSP)
+    const bool wasFullyBypassed = bypassStage.isFullyBypassed();
+    bypassStage.setBypassed(hostBypassed || *parameters.getRawParameterValue("bypass") > 0.5f);
+    bypassStage.pushDry(buffer);
 
-    // Actualiza las ganancias del ecualizador con los valores actuales de parámetros
+    if (bypassStage.isFullyBypassed())
+    {
+        bypassStage.process(buffer);
+        outputMeter.process(buffer);
+        return;
+    }
+
+    // Al salir del bypass la cadena arranca limpia: su estado es de antes del bypass
+    if (wasFullyBypassed)
+    {
+        eq.reset();
+        limiter.reset();
+        updateOutputStage();
+        outputStage.reset();
+    }
+
+    // Actualiza la topología y las ganancias del ecualizador con los valores actuales de parámetros
+    eq.setTopology(static_cast<SimpleEQ::Topology>((int)*parameters.getRawParameterValue("filterTopology")));
     eq.setGains(
         *parameters.getRawParameterValue("lowGain"),
         *parameters.getRawParameterValue("midGain"),
         *parameters.getRawParameterValue("highGain")
     );
+    eq.setSideGains(
+        *parameters.getRawParameterValue("sideLowGain"),
+        *parameters.getRawParameterValue("sideMidGain"),
+        *parameters.getRawParameterValue("sideHighGain")
+    );
 
-    eq.process(buffer); // Procesa el buffer con el ecualizador
+    // En M/S la codificación y decodificación van dentro del bucle de los filtros; el pan y el ancho
+    // de outputStage trabajan después, sobre L/R ya decodificado
+    eq.setStereoMode(static_cast<SimpleEQ::StereoMode>((int)*parameters.getRawParameterValue("stereoMode")));
 
-    // Calcula el balance estéreo tipo "constant power" para el PAN
-    float angle = (pan + 1.0f) * 0.5f * juce::MathConstants<float>::halfPi; // Ángulo entre 0 y π/2
-    float leftGain = std::cos(angle);  // Ganancia para canal izquierdo
-    float rightGain = std::sin(angle); // Ganancia para canal derecho
+    // Auto gain en M/S: reparto de energía entre mid y side de la entrada a la EQ
+    if (*parameters.getRawParameterValue("autoGain") > 0.5f
+        && (int)*parameters.getRawParameterValue("stereoMode") == (int)SimpleEQ::StereoMode::midSide)
+        autoGain.measureStereoBalance(buffer, getSampleRate());
 
-    // Aplica ganancia y pan según número de canales
-    if (numChannels >= 2)
-    {
-        buffer.applyGain(0, 0, numSamples, gain * leftGain);  // Aplica ganancia al canal izquierdo
-        buffer.applyGain(1, 0, numSamples, gain * rightGain); // Aplica ganancia al canal derecho
-    }
-    else if (numChannels == 1)
-    {
-        buffer.applyGain(gain); // Si es mono, solo aplica ganancia sin pan
-    }
+    // Bandas dinámicas: con "Sidechain" elegido y el bus conectado, escuchan el sidechain
+    updateDynamics();
+    const bool useSidechain = (int)*parameters.getRawParameterValue("dynamicKey") == 1 && sidechain.getNumChannels() > 0;
+
+    eq.process(buffer, useSidechain ? &sidechain : nullptr); // Procesa el buffer con el ecualizador
+
+    // Aplica ancho, pan y ganancia con rampas por muestra (sin saltos entre bloques)
+    updateOutputStage();
+    outputStage.process(buffer);
+
+    // Limitador al final de la cadena (sus parámetros y la latencia ya se actualizaron al principio)
+    limiter.process(buffer);
+
+    // Fundido con la señal seca mientras el bypass cambia (sin fundido no toca el buffer)
+    bypassStage.process(buffer);
+
+    outputMeter.process(buffer); // Mide la señal de salida
+}
+
+// Lanza el "EQ match": el análisis corre en un pool de hilos y el resultado llega al hilo de mensajes
+void Filter_FlowAudioProcessor::startEQMatch(const juce::File& reference, const juce::File& target)
+{
+    lastEQMatchMessage = "Analizando...";
+
+    eqMatcher.startMatch(reference, target, getSampleRate(), [this](const EQMatcher::Result& result)
+        {
+            lastEQMatchMessage = result.message;
+
+            if (! result.succeeded)
+                return;
+
+            // Aplica las ganancias como si el usuario moviera los sliders (el host registra la automatización)
+            const char* ids[SimpleEQ::numBands] = { "lowGain", "midGain", "highGain" };
+            for (int band = 0; band < SimpleEQ::numBands; ++band)
+            {
+                if (auto* parameter = parameters.getParameter(ids[band]))
+                {
+                    parameter->beginChangeGesture();
+                    parameter->setValueNotifyingHost(parameter->convertTo0to1(result.gains[(size_t)band]));
+                    parameter->endChangeGesture();
+                }
+            }
+        });
 }
 
 // Indica que el plugin tiene interfaz gráfica
@@ -153,6 +466,14 @@ bool Filter_FlowAudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
     // Entrada debe coincidir con la salida (ambas estéreo)
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // El sidechain es opcional: desactivado, mono o estéreo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechainSet = layouts.getChannelSet(true, 1);
+        if (! sidechainSet.isDisabled() && sidechainSet != juce::AudioChannelSet::mono() && sidechainSet != juce::AudioChannelSet::stereo())
+            return false;
+    }
 #endif
 
     return true; // Layout soportado
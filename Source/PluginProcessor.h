@@ -2,9 +2,19 @@
 
 #include <JuceHeader.h>  // Incluye todas las cabeceras principales de JUCE
 #include "SimpleEQ.h"    // Incluye la definicin de la clase SimpleEQ (tu ecualizador)
+#include "OutputStage.h" // Etapa de salida con ganancia, paneo y ancho estreo suavizados
+#include "EQMatcher.h"   // "EQ match" offline entre un archivo de referencia y uno objetivo
+#include "LevelMeter.h"  // Medidores de pico, RMS y LUFS
+#include "AutoGain.h"    // Compensacin de ganancia calculada a partir de la respuesta de la EQ
+#include "CpuGovernor.h" // Niveles de calidad segn la carga de CPU
+#include "AutomationRecorder.h" // Captura de automatizacin para reproducirla fuera del host
+#include "LookaheadLimiter.h" // Limitador con anticipacin al final de la cadena
+#include "BypassStage.h" // Bypass con fundido y seal seca alineada con la latencia
 
 // Definicin de la clase principal del plugin que procesa audio
-class Filter_FlowAudioProcessor : public juce::AudioProcessor
+// Hereda de Timer para recalcular la compensacin de ganancia fuera del hilo de audio
+class Filter_FlowAudioProcessor : public juce::AudioProcessor,
+    private juce::Timer
 {
 public:
     Filter_FlowAudioProcessor();          // Constructor
@@ -22,6 +32,12 @@ public:
     // Aqu aplics la DSP, filtros, efectos, etc.
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // Bypass pedido por el host: sigue el mismo camino que el parmetro "bypass" (fundido y retardo)
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    // El parmetro "bypass" es el bypass del host
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+
     // Crea el editor grfico (interfaz) del plugin
     juce::AudioProcessorEditor* createEditor() override;
 
@@ -79,7 +95,82 @@ public:
     // Instancia del procesador de ecualizacin (tu DSP)
     SimpleEQ eq;
 
+    // Medidores de entrada (antes de la EQ) y salida (final de la cadena); la interfaz lee sus atmicos.
+    // La interfaz solo muestra la sonoridad de la salida: la entrada mide pico y RMS
+    LevelMeter inputMeter { false }, outputMeter { true };
+    bool measureInput = true;  // El nivel de calidad mnimo apaga el medidor de entrada
+
+    // Limitador de salida (la interfaz lee su reduccin de ganancia)
+    LookaheadLimiter limiter;
+
+    // Gobernador de CPU (la interfaz muestra el nivel actual y ajusta su refresco)
+    CpuGovernor cpuGovernor;
+
+    // Analiza ambos archivos en segundo plano y, al terminar, ajusta las ganancias de las bandas
+    // (se llama desde el hilo de mensajes)
+    void startEQMatch(const juce::File& reference, const juce::File& target);
+
+    // Tools/AutomationReplay: impone la compensacin de auto gain grabada en la captura (hilo de mensajes).
+    // Sin bucle de mensajes el timer que la calcula no correra
+    void setRecordedAutoGainCompensation(float gain);
+
+    // Indica si hay un "EQ match" en curso y devuelve el mensaje del ltimo resultado (hilo de mensajes)
+    bool isEQMatchRunning() const noexcept { return eqMatcher.isMatching(); }
+    const juce::String& getLastEQMatchMessage() const noexcept { return lastEQMatchMessage; }
+
 private:
+    // Lee los parmetros de ganancia, paneo y ancho y los pasa a la etapa de salida
+    void updateOutputStage();
+
+    // Lee los parmetros de las bandas dinmicas y los pasa al ecualizador
+    void updateDynamics();
+
+    // Pasa a la EQ el suavizado de coeficientes del nivel de calidad actual
+    void applyQualityTier();
+
+    // Lee los parmetros de saturacin y los pasa al ecualizador
+    void updateDrive();
+
+    // Lee los parmetros del limitador
+    void updateLimiter();
+
+    // Suma la latencia de la saturacin y del limitador y la reporta al host si cambi
+    void updateLatency();
+
+    // processBlock y processBlockBypassed: hostBypassed fuerza el bypass adems del parmetro
+    void processChain(juce::AudioBuffer<float>& hostBuffer, bool hostBypassed);
+
+    // Recalcula la compensacin automtica de ganancia (hilo de mensajes)
+    void timerCallback() override;
+
+    // Etapa final de ganancia/paneo/ancho con rampas por muestra
+    OutputStage outputStage;
+
+    // Bypass con fundido; la seal seca pasa por un retardo igual a la latencia reportada
+    BypassStage bypassStage;
+    static constexpr int maxExtraLatency = 64;  // Latencia mxima fuera del limitador (true peak + sobremuestreo), con margen
+
+    // Parmetros de cada banda dinmica (punteros guardados en el constructor)
+    struct DynamicParameters
+    {
+        std::atomic<float>* enabled = nullptr;
+        std::atomic<float>* threshold = nullptr;
+        std::atomic<float>* ratio = nullptr;
+        std::atomic<float>* attack = nullptr;
+        std::atomic<float>* release = nullptr;
+    };
+    std::array<DynamicParameters, SimpleEQ::numBands> dynamicParameters;
+
+    // Compensacin automtica de ganancia (se aplica en la etapa de salida)
+    AutoGain autoGain;
+
+    // Anlisis offline para el "EQ match" y mensaje de su ltimo resultado
+    EQMatcher eqMatcher;
+    juce::String lastEQMatchMessage;
+
+    // Captura por bloque de parmetros y tamao de bloque (inactiva sin FILTER_FLOW_CAPTURE)
+    AutomationRecorder automationRecorder { *this };
+
     // Evita que la clase sea copiada accidentalmente y ayuda a detectar fugas de memoria en modo debug
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Filter_FlowAudioProcessor)
 };
\ No newline at end of file
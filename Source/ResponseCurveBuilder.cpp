@@ -0,0 +1,126 @@
+#include "ResponseCurveBuilder.h"
+
+ResponseCurveBuilder::ResponseCurveBuilder() : juce::Thread("Filter_Flow response curves")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+ResponseCurveBuilder::~ResponseCurveBuilder()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(1000);
+}
+
+// Las fotos iguales no generan trabajo: con los controles quietos el hilo duerme
+void ResponseCurveBuilder::post(const Snapshot& snapshot)
+{
+    if (snapshot == lastPosted)
+        return;
+
+    lastPosted = snapshot;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        pendingSnapshot = snapshot;
+        ++pendingVersion;
+    }
+
+    notify();
+}
+
+bool ResponseCurveBuilder::acquireLatest() noexcept
+{
+    if ((readyState.load(std::memory_order_acquire) & freshBit) == 0)
+        return false;
+
+    // Entrega la ranura leída y se queda con la última lista
+    readSlot = readyState.exchange(readSlot, std::memory_order_acq_rel) & indexMask;
+    return true;
+}
+
+void ResponseCurveBuilder::run()
+{
+    juce::uint32 builtVersion = 0;
+
+    while (! threadShouldExit())
+    {
+        Snapshot snapshot;
+        juce::uint32 version;
+
+        {
+            const juce::SpinLock::ScopedLockType lock(snapshotLock);
+            snapshot = pendingSnapshot;
+            version = pendingVersion;
+        }
+
+        if (version == builtVersion)
+        {
+            wait(-1);
+            continue;
+        }
+
+        auto& curves = slots[(size_t)writeSlot];
+        build(snapshot, curves);
+        curves.version = version;
+        builtVersion = version;
+
+        // Publica la ranura escrita y recibe la que quedó libre (la lista anterior, si nadie la tomó)
+        writeSlot = readyState.exchange(writeSlot | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+}
+
+// Magnitud de cada banda en una rejilla logarítmica de 20 Hz a 20 kHz, un punto por píxel
+void ResponseCurveBuilder::build(const Snapshot& snapshot, Curves& curves)
+{
+    FILTER_FLOW_TRACE_SCOPE("buildResponseCurves");
+
+    for (auto& path : curves.bands)
+        path.clear();
+    curves.side.clear();
+
+    const auto& bounds = snapshot.bounds;
+    const int numPoints = juce::roundToInt(bounds.getWidth());
+    if (numPoints < 2)
+        return;
+
+    // Mapea de -24 dB a +24 dB en la altura del área de dibujo
+    auto mapToY = [&bounds](float magnitude)
+        {
+            const float dB = juce::Decibels::gainToDecibels(magnitude);
+            return juce::jmap(dB, -24.0f, 24.0f, bounds.getBottom(), bounds.getY());
+        };
+
+    const auto& midGains = snapshot.gainsDecibels[SimpleEQ::midComponent];
+    const auto& sideGains = snapshot.gainsDecibels[SimpleEQ::sideComponent];
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const double frequency = 20.0 * std::pow(10.0, 3.0 * i / (numPoints - 1));
+        const float x = bounds.getX() + (float)i;
+
+        float sideMagnitude = 1.0f;
+
+        for (int band = 0; band < SimpleEQ::numBands; ++band)
+        {
+            const float magnitude = SimpleEQ::getMagnitudeForFrequency(band, midGains[(size_t)band], snapshot.sampleRate, frequency);
+
+            if (i == 0)
+                curves.bands[(size_t)band].startNewSubPath(x, mapToY(magnitude));
+            else
+                curves.bands[(size_t)band].lineTo(x, mapToY(magnitude));
+
+            if (snapshot.midSide)
+                sideMagnitude *= SimpleEQ::getMagnitudeForFrequency(band, sideGains[(size_t)band], snapshot.sampleRate, frequency);
+        }
+
+        // En M/S también la respuesta total de side (las tres bandas en serie)
+        if (snapshot.midSide)
+        {
+            if (i == 0)
+                curves.side.startNewSubPath(x, mapToY(sideMagnitude));
+            else
+                curves.side.lineTo(x, mapToY(sideMagnitude));
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+#include "SimpleEQ.h"    // Bandas y respuesta en frecuencia de la EQ
+
+// Clase ResponseCurveBuilder: calcula las curvas de respuesta de la EQ en un hilo propio.
+// El editor publica una "foto" versionada de las ganancias (leídas de los atómicos de SimpleEQ, nunca de
+// los filtros del hilo de audio) y el hilo arma los Path solo cuando la versión cambia. Los resultados
+// viven en tres ranuras que se intercambian con un índice atómico: el hilo escribe en una, paint() lee
+// otra y la tercera guarda el último resultado listo, así ninguno de los dos espera al otro.
+class ResponseCurveBuilder : private juce::Thread
+{
+public:
+    // Lo que hace falta para dibujar las curvas: ganancias (estática + dinámica), modo y zona de dibujo
+    struct Snapshot
+    {
+        std::array<std::array<float, SimpleEQ::numBands>, SimpleEQ::numComponents> gainsDecibels {};
+        double sampleRate = 0.0;
+        bool midSide = false;
+        juce::Rectangle<float> bounds;
+
+        bool operator==(const Snapshot& other) const noexcept
+        {
+            return gainsDecibels == other.gainsDecibels && sampleRate == other.sampleRate
+                && midSide == other.midSide && bounds == other.bounds;
+        }
+
+        bool operator!=(const Snapshot& other) const noexcept { return ! (*this == other); }
+    };
+
+    // Curvas listas para dibujar: una por banda y la respuesta total de side (vacía en L/R)
+    struct Curves
+    {
+        juce::uint32 version = 0;
+        std::array<juce::Path, SimpleEQ::numBands> bands;
+        juce::Path side;
+    };
+
+    ResponseCurveBuilder();
+    ~ResponseCurveBuilder() override;
+
+    // Hilo de mensajes: publica una foto nueva si difiere de la anterior y despierta al hilo
+    void post(const Snapshot& snapshot);
+
+    // Hilo de mensajes: si hay un resultado más nuevo lo toma; devuelve true si cambió
+    bool acquireLatest() noexcept;
+
+    // Hilo de mensajes: las curvas tomadas por el último acquireLatest()
+    const Curves& getCurves() const noexcept { return slots[(size_t)readSlot]; }
+
+private:
+    void run() override;
+
+    // Calcula las curvas de una foto en la ranura de escritura
+    void build(const Snapshot& snapshot, Curves& curves);
+
+    // Foto pendiente (protegida por el spin lock: solo la copian el editor y el hilo)
+    juce::SpinLock snapshotLock;
+    Snapshot pendingSnapshot, lastPosted;
+    juce::uint32 pendingVersion = 0;
+
+    // Tres ranuras: lectura (hilo de mensajes), escritura (hilo de cálculo) y la última lista.
+    // readyState guarda el índice de la lista y freshBit indica que todavía no se leyó
+    static constexpr int freshBit = 4, indexMask = 3;
+    std::array<Curves, 3> slots;
+    std::atomic<int> readyState { 1 };
+    int readSlot = 0, writeSlot = 2;
+
+    JUCE_DECLARE_NON_COPYABLE(ResponseCurveBuilder)
+};
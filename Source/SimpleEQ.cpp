@@ -1,11 +1,19 @@
 #include "SimpleEQ.h"
 
-// Constructor: inicializa los punteros a coeficientes en nullptr
+// Constructor: todas las bandas arrancan en 0 dB
 SimpleEQ::SimpleEQ()
 {
-    lowCoefficients = nullptr;
-    midCoefficients = nullptr;
-    highCoefficients = nullptr;
+    for (auto& componentGains : gainsDecibels)
+        for (auto& gain : componentGains)
+            gain.store(0.0f);
+
+    for (auto& gain : dynamicGainsDecibels)
+        gain.store(0.0f);
+
+    // Crea un objeto de coeficientes por banda y componente (los filtros de cada canal apuntan a ellos)
+    for (auto& componentCoefficients : biquadCoefficients)
+        for (auto& coefficients : componentCoefficients)
+            coefficients = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
 }
 
 // Prepara los filtros con las especificaciones del audio (sample rate, block size, canales)
@@ -13,50 +21,582 @@ void SimpleEQ::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;  // Guarda la frecuencia de muestreo actual
 
-    // Crea coeficientes para el filtro Low Shelf (bajos) con frecuencia 100 Hz, Q = 0.707, ganancia 0 dB (sin cambio)
-    lowCoefficients = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, 100.0f, 0.707f, juce::Decibels::decibelsToGain(0.0f));
+    // Pre-deformacin de la frecuencia de cada banda: el nico tan() que necesita el SVF
+    for (int band = 0; band < numBands; ++band)
+        warpedFrequencies[(size_t)band] = static_cast<float>(std::tan(juce::MathConstants<double>::pi * bandFrequencies[band] / sampleRate));
+
+    // Crea un juego de filtros por canal (los filtros IIR de JUCE son mono)
+    biquadFilters.resize(spec.numChannels);
+    svfFilters.resize(spec.numChannels);
+
+    juce::dsp::ProcessSpec monoSpec = spec;
+    monoSpec.numChannels = 1;
+
+    for (size_t channel = 0; channel < biquadFilters.size(); ++channel)
+    {
+        for (int band = 0; band < numBands; ++band)
+        {
+            biquadFilters[channel][(size_t)band].coefficients = biquadCoefficients[(size_t)getComponent((int)channel)][(size_t)band];
+            biquadFilters[channel][(size_t)band].prepare(monoSpec);
+        }
+    }
+
+    // Calcula los coeficientes de la topologa activa para las ganancias actuales
+    for (int component = 0; component < numComponents; ++component)
+        for (int band = 0; band < numBands; ++band)
+            updateBand(component, band);
+
+    // Prepara la etapa de saturacin (el sobremuestreo vive solo dentro de ella)
+    drive.prepare(spec);
+
+    // Bandas dinmicas: tablas de coeficientes, mezcla mono de la seal de control y detectores.
+    // El detector de cada banda escucha la zona que la banda modifica
+    maxBlockSize = juce::jmax(1, (int)spec.maximumBlockSize);
+    maxSubBlocks = (maxBlockSize + dynamicSubBlockSize - 1) / dynamicSubBlockSize;
+    keyMix.allocate((size_t)maxBlockSize, true);
+    dynamicGains.assign((size_t)(numBands * maxSubBlocks), 0.0f);
+
+    buildCoefficientTables();
+
+    using IIRCoefficients = juce::dsp::IIR::Coefficients<float>;
+    detectors[lowBand].prepare(sampleRate, maxBlockSize, dynamicSubBlockSize, IIRCoefficients::makeLowPass(sampleRate, bandFrequencies[lowBand]));
+    detectors[midBand].prepare(sampleRate, maxBlockSize, dynamicSubBlockSize, IIRCoefficients::makeBandPass(sampleRate, bandFrequencies[midBand], bandQ));
+    detectors[highBand].prepare(sampleRate, maxBlockSize, dynamicSubBlockSize, IIRCoefficients::makeHighPass(sampleRate, bandFrequencies[highBand]));
+
+    reset();
+}
+
+// Limpia el estado de todos los filtros
+void SimpleEQ::reset()
+{
+    for (auto& channelFilters : biquadFilters)
+        for (auto& filter : channelFilters)
+            filter.reset();
+
+    for (auto& channelFilters : svfFilters)
+        for (auto& filter : channelFilters)
+            filter.reset();
+
+    svfCurrent = svfTarget;  // Sin interpolacin pendiente tras un reset
+
+    for (auto& detector : detectors)
+        detector.reset();
 
-    // Crea coeficientes para el filtro Peak (medio) con frecuencia 1000 Hz, Q = 0.707, ganancia 0 dB
-    midCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 1000.0f, 0.707f, juce::Decibels::decibelsToGain(0.0f));
+    previousDynamicGains.fill(0.0f);
 
-    // Crea coeficientes para el filtro High Shelf (agudos) con frecuencia 5000 Hz, Q = 0.707, ganancia 0 dB
-    highCoefficients = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 5000.0f, 0.707f, juce::Decibels::decibelsToGain(0.0f));
+    drive.reset();
+}
+
+// Cambia la topologa; los coeficientes de la nueva se ponen al da y su estado se limpia
+void SimpleEQ::setTopology(Topology newTopology)
+{
+    if (newTopology == topology)
+        return;
+
+    topology = newTopology;
+
+    for (int component = 0; component < numComponents; ++component)
+        for (int band = 0; band < numBands; ++band)
+            updateBand(component, band);
 
-    // Asigna los coeficientes a cada filtro correspondiente
-    lowFilter.coefficients = lowCoefficients;
-    midFilter.coefficients = midCoefficients;
-    highFilter.coefficients = highCoefficients;
+    if (topology == Topology::biquad)
+    {
+        for (auto& channelFilters : biquadFilters)
+            for (auto& filter : channelFilters)
+                filter.reset();
+    }
+    else
+    {
+        for (auto& channelFilters : svfFilters)
+            for (auto& filter : channelFilters)
+                filter.reset();
 
-    // Prepara los filtros con las especificaciones (para que se configuren internamente)
-    lowFilter.prepare(spec);
-    midFilter.prepare(spec);
-    highFilter.prepare(spec);
+        svfCurrent = svfTarget;
+    }
+}
+
+// Cambia entre L/R y M/S. El canal 1 pasa a usar los coeficientes de su nueva componente y el estado
+// de todos los filtros se limpia: lo que guardaban corresponda a otra seal
+void SimpleEQ::setStereoMode(StereoMode newMode)
+{
+    if (newMode == stereoMode)
+        return;
+
+    stereoMode = newMode;
+
+    for (size_t channel = 0; channel < biquadFilters.size(); ++channel)
+    {
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto& filter = biquadFilters[channel][(size_t)band];
+            filter.coefficients = biquadCoefficients[(size_t)getComponent((int)channel)][(size_t)band];
+            filter.reset();
+        }
+    }
+
+    for (auto& channelFilters : svfFilters)
+        for (auto& filter : channelFilters)
+            filter.reset();
+
+    svfCurrent = svfTarget;
+}
+
+// Actualiza la curva y cantidad de saturacin, y su posicin respecto a los filtros
+void SimpleEQ::setDrive(DriveStage::Curve curve, float driveDecibels, bool beforeFilters)
+{
+    drive.setParameters(curve, driveDecibels);
+    driveBeforeFilters = beforeFilters;
 }
 
 // Actualiza las ganancias de los filtros con los valores recibidos (en decibeles)
 void SimpleEQ::setGains(float low, float mid, float high)
 {
-    // Recalcula los coeficientes para el filtro de bajos con la nueva ganancia low (convertida de dB a ganancia lineal)
-    *lowCoefficients = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, 100.0f, 0.707f, juce::Decibels::decibelsToGain(low));
+    const float gains[numBands] = { low, mid, high };
+    setComponentGains(midComponent, gains);
+}
+
+// Ganancias de la componente side; se mantienen al da tambin en L/R para que el cambio de modo sea inmediato
+void SimpleEQ::setSideGains(float low, float mid, float high)
+{
+    const float gains[numBands] = { low, mid, high };
+    setComponentGains(sideComponent, gains);
+}
+
+void SimpleEQ::setComponentGains(int component, const float (&gains)[numBands])
+{
+    auto& current = gainsDecibels[(size_t)component];
+
+    // Solo recalcula las bandas cuya ganancia cambi desde el ltimo bloque
+    for (int band = 0; band < numBands; ++band)
+    {
+        if (gains[band] != current[(size_t)band].load())
+        {
+            current[(size_t)band].store(gains[band]);
+            updateBand(component, band);
+        }
+    }
+}
+
+// Crea los coeficientes SVF de una banda: sin trigonometra, solo la conversin de dB a ganancia
+SvfCoefficients SimpleEQ::makeSvfCoefficients(int band, float warpedFrequency, float gainDecibels) noexcept
+{
+    const float gainFactor = juce::Decibels::decibelsToGain(gainDecibels);
+
+    switch (band)
+    {
+        case lowBand:  return SvfCoefficients::makeLowShelf(warpedFrequency, bandQ, gainFactor);
+        case highBand: return SvfCoefficients::makeHighShelf(warpedFrequency, bandQ, gainFactor);
+        case midBand:
+        default:       return SvfCoefficients::makePeak(warpedFrequency, bandQ, gainFactor);
+    }
+}
+
+// Recalcula los coeficientes de una banda solo para la topologa que se est usando
+void SimpleEQ::updateBand(int component, int band)
+{
+    FILTER_FLOW_TRACE_SCOPE("SimpleEQ::updateCoefficients");
+
+    const float gainDecibels = gainsDecibels[(size_t)component][(size_t)band].load();
+
+    if (topology == Topology::svf)
+    {
+        // El objetivo cambia y process() interpola hacia l muestra a muestra
+        svfTarget[(size_t)component][(size_t)band] = makeSvfCoefficients(band, warpedFrequencies[(size_t)band], gainDecibels);
+        return;
+    }
+
+    *biquadCoefficients[(size_t)component][(size_t)band] = *makeBiquadCoefficients(band, gainDecibels);
+}
+
+// Coeficientes biquad RBJ de una banda (filtro de bajos, medios o agudos)
+juce::dsp::IIR::Coefficients<float>::Ptr SimpleEQ::makeBiquadCoefficients(int band, float gainDecibels) const
+{
+    const float gainFactor = juce::Decibels::decibelsToGain(gainDecibels);
+    const float frequency = bandFrequencies[band];
+
+    if (band == lowBand)
+        return juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, frequency, bandQ, gainFactor);
+    if (band == midBand)
+        return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, frequency, bandQ, gainFactor);
+
+    return juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, frequency, bandQ, gainFactor);
+}
+
+// Precalcula los coeficientes de cada banda para toda la rejilla de ganancias (solo en prepare)
+void SimpleEQ::buildCoefficientTables()
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        svfTable[(size_t)band].resize(tableSize);
+        biquadTable[(size_t)band].resize(tableSize);
+
+        for (int i = 0; i < tableSize; ++i)
+        {
+            const float gainDecibels = tableMinDecibels + (float)i * tableStepDecibels;
+
+            svfTable[(size_t)band][(size_t)i] = makeSvfCoefficients(band, warpedFrequencies[(size_t)band], gainDecibels);
+
+            const auto biquad = makeBiquadCoefficients(band, gainDecibels);
+            std::copy(biquad->getRawCoefficients(), biquad->getRawCoefficients() + 5, biquadTable[(size_t)band][(size_t)i].begin());
+        }
+    }
+}
+
+// Activa, desactiva o ajusta la parte dinmica de una banda
+void SimpleEQ::setDynamics(int band, const DynamicBandDetector::Settings& settings)
+{
+    auto& detector = detectors[(size_t)band];
+    const bool wasEnabled = detector.isEnabled();
+
+    detector.setSettings(settings);
+
+    // Al desactivarla, la banda vuelve a sus coeficientes estticos
+    if (wasEnabled && ! settings.enabled)
+    {
+        dynamicGainsDecibels[(size_t)band].store(0.0f);
+        previousDynamicGains[(size_t)band] = 0.0f;
+        updateBand(midComponent, band);
+    }
+}
+
+bool SimpleEQ::hasDynamicBands() const noexcept
+{
+    for (const auto& detector : detectors)
+        if (detector.isEnabled())
+            return true;
+
+    return false;
+}
+
+// Procesa un canal con las tres bandas SVF en serie, interpolando los coeficientes hacia el objetivo
+void SimpleEQ::processSvfChannel(int channel, float* data, int numSamples) noexcept
+{
+    auto& filters = svfFilters[(size_t)channel];
+    const auto& current = svfCurrent[(size_t)getComponent(channel)];
+    const auto& target = svfTarget[(size_t)getComponent(channel)];
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto& filter = filters[(size_t)band];
+        auto coefficients = current[(size_t)band];
+
+        if (coefficients == target[(size_t)band])
+        {
+            // Coeficientes estables: bucle simple
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = filter.processSample(data[i], coefficients);
+        }
+        else
+        {
+            // Modulacin: los coeficientes avanzan linealmente hasta el objetivo, un paso cada
+            // smoothingInterval muestras (1 = en cada muestra, la mxima calidad)
+            const int numSteps = (numSamples + smoothingInterval - 1) / smoothingInterval;
+            const auto increment = coefficients.getIncrementTowards(target[(size_t)band], numSteps);
+
+            for (int start = 0; start < numSamples; start += smoothingInterval)
+            {
+                coefficients.advance(increment);
+
+                const int end = juce::jmin(numSamples, start + smoothingInterval);
+                for (int i = start; i < end; ++i)
+                    data[i] = filter.processSample(data[i], coefficients);
+            }
+        }
+
+        filter.snapToZero();
+    }
+}
+
+// M/S con SVF: por muestra, mid = (L + R) / 2 y side = (L - R) / 2 pasan por sus tres bandas y se
+// decodifican en el mismo paso (L = mid + side, R = mid - side). La interpolacin de coeficientes es la
+// misma que la de processSvfChannel, para las seis bandas a la vez
+void SimpleEQ::processMidSideSvf(float* left, float* right, int numSamples) noexcept
+{
+    auto& midFilters = svfFilters[0];
+    auto& sideFilters = svfFilters[1];
+
+    auto mid = svfCurrent[midComponent];
+    auto side = svfCurrent[sideComponent];
+    const bool modulating = mid != svfTarget[midComponent] || side != svfTarget[sideComponent];
+
+    // Sin modulacin el tramo entero es un nico paso y los incrementos no se usan
+    const int interval = modulating ? smoothingInterval : numSamples;
+    const int numSteps = (numSamples + interval - 1) / interval;
+
+    std::array<SvfCoefficients, numBands> midIncrement, sideIncrement;
+    if (modulating)
+    {
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            midIncrement[band] = mid[band].getIncrementTowards(svfTarget[midComponent][band], numSteps);
+            sideIncrement[band] = side[band].getIncrementTowards(svfTarget[sideComponent][band], numSteps);
+        }
+    }
+
+    for (int start = 0; start < numSamples; start += interval)
+    {
+        if (modulating)
+        {
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                mid[band].advance(midIncrement[band]);
+                side[band].advance(sideIncrement[band]);
+            }
+        }
+
+        const int end = juce::jmin(numSamples, start + interval);
+        for (int i = start; i < end; ++i)
+        {
+            float m = 0.5f * (left[i] + right[i]);
+            float s = 0.5f * (left[i] - right[i]);
+
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                m = midFilters[band].processSample(m, mid[band]);
+                s = sideFilters[band].processSample(s, side[band]);
+            }
+
+            left[i] = m + s;
+            right[i] = m - s;
+        }
+    }
+
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        midFilters[band].snapToZero();
+        sideFilters[band].snapToZero();
+    }
+}
+
+// M/S con biquad: misma codificacin y decodificacin fundidas en el bucle, con los filtros IIR muestra a muestra
+void SimpleEQ::processMidSideBiquad(float* left, float* right, int numSamples) noexcept
+{
+    auto& midFilters = biquadFilters[0];
+    auto& sideFilters = biquadFilters[1];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float m = 0.5f * (left[i] + right[i]);
+        float s = 0.5f * (left[i] - right[i]);
+
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            m = midFilters[band].processSample(m);
+            s = sideFilters[band].processSample(s);
+        }
+
+        left[i] = m + s;
+        right[i] = m - s;
+    }
+
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        midFilters[band].snapToZero();
+        sideFilters[band].snapToZero();
+    }
+}
+
+// Aplica los filtros de las tres bandas a un tramo [start, start + numSamples) del buffer
+void SimpleEQ::processFilters(juce::AudioBuffer<float>& buffer, int start, int numSamples)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int)biquadFilters.size());
+
+    // M/S necesita el par estreo; con un solo canal se procesa como L/R (mid = la seal)
+    if (stereoMode == StereoMode::midSide && numChannels >= 2)
+    {
+        float* left = buffer.getWritePointer(0, start);
+        float* right = buffer.getWritePointer(1, start);
+
+        if (topology == Topology::svf)
+        {
+            processMidSideSvf(left, right, numSamples);
+            svfCurrent = svfTarget;
+        }
+        else
+        {
+            processMidSideBiquad(left, right, numSamples);
+        }
+
+        return;
+    }
+
+    if (topology == Topology::svf)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            processSvfChannel(channel, buffer.getWritePointer(channel, start), numSamples);
+
+        svfCurrent = svfTarget;  // Todos los canales llegaron al objetivo al final del tramo
+    }
+    else
+    {
+        // Crea un bloque de audio que envuelve al tramo del buffer para procesarlo
+        auto block = juce::dsp::AudioBlock<float>(buffer).getSubBlock((size_t)start, (size_t)numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            // Cada canal tiene sus propios filtros (los IIR de JUCE procesan un nico canal)
+            auto channelBlock = block.getSingleChannelBlock((size_t)channel);
+            juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+
+            // Procesa el audio con cada filtro (low, mid, high) aplicndolos en orden
+            for (auto& filter : biquadFilters[(size_t)channel])
+                filter.process(context);
+        }
+    }
+}
+
+// Mezcla la seal de control a mono y calcula el ajuste de ganancia de cada banda dinmica por sub-bloque
+void SimpleEQ::analyseDynamics(const juce::AudioBuffer<float>& key, int start, int numSamples)
+{
+    const int numKeyChannels = key.getNumChannels();
+
+    juce::FloatVectorOperations::copy(keyMix.get(), key.getReadPointer(0, start), numSamples);
+    for (int channel = 1; channel < numKeyChannels; ++channel)
+        juce::FloatVectorOperations::add(keyMix.get(), key.getReadPointer(channel, start), numSamples);
+    if (numKeyChannels > 1)
+        juce::FloatVectorOperations::multiply(keyMix.get(), 1.0f / (float)numKeyChannels, numSamples);
+
+    const int numSubBlocks = (numSamples + dynamicSubBlockSize - 1) / dynamicSubBlockSize;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        float* gains = dynamicGains.data() + (size_t)(band * maxSubBlocks);
+
+        if (detectors[(size_t)band].isEnabled())
+        {
+            detectors[(size_t)band].process(keyMix.get(), numSamples, gains);
+            dynamicGainsDecibels[(size_t)band].store(gains[numSubBlocks - 1]);
+        }
+    }
+}
+
+// Interpola linealmente entre las dos entradas de la tabla que rodean la ganancia pedida (sin trigonometra
+// ni memoria nueva): entre entradas separadas 0.25 dB los coeficientes son casi lineales en la ganancia
+void SimpleEQ::applyTableCoefficients(int band, float gainDecibels) noexcept
+{
+    const float position = (juce::jlimit(tableMinDecibels, tableMaxDecibels, gainDecibels) - tableMinDecibels) / tableStepDecibels;
+    const int index = juce::jmin((int)position, tableSize - 2);
+    const float frac = position - (float)index;
+
+    auto lerp = [frac](float a, float b) { return a + (b - a) * frac; };
+
+    if (topology == Topology::svf)
+    {
+        const auto& a = svfTable[(size_t)band][(size_t)index];
+        const auto& b = svfTable[(size_t)band][(size_t)index + 1];
+        auto& target = svfTarget[midComponent][(size_t)band];
+
+        target.g = lerp(a.g, b.g);
+        target.k = lerp(a.k, b.k);
+        target.a1 = lerp(a.a1, b.a1);
+        target.a2 = lerp(a.a2, b.a2);
+        target.a3 = lerp(a.a3, b.a3);
+        target.m0 = lerp(a.m0, b.m0);
+        target.m1 = lerp(a.m1, b.m1);
+        target.m2 = lerp(a.m2, b.m2);
+    }
+    else
+    {
+        const auto& a = biquadTable[(size_t)band][(size_t)index];
+        const auto& b = biquadTable[(size_t)band][(size_t)index + 1];
+        float* raw = biquadCoefficients[midComponent][(size_t)band]->getRawCoefficients();
+
+        for (size_t i = 0; i < a.size(); ++i)
+            raw[i] = lerp(a[i], b[i]);
+    }
+}
+
+// Procesa el buffer de audio aplicando los tres filtros en serie. Se trabaja en tramos de como mximo
+// maxBlockSize muestras; con bandas dinmicas, cada tramo se divide en sub-bloques y los coeficientes
+// de esas bandas se actualizan desde las tablas: en SVF al principio de cada sub-bloque (el filtro
+// interpola hacia ellos por muestra) y en biquad en varios pasos, con la ganancia en rampa desde el
+// sub-bloque anterior, para que los coeficientes no salten de golpe
+void SimpleEQ::process(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* keyBuffer)
+{
+    FILTER_FLOW_TRACE_SCOPE("SimpleEQ::process");
+
+    const int totalSamples = buffer.getNumSamples();
+    const bool dynamic = hasDynamicBands();
+
+    // Sin sidechain, la seal de control es la propia entrada (antes de saturacin y filtros)
+    const auto& key = keyBuffer != nullptr && keyBuffer->getNumChannels() > 0 ? *keyBuffer : buffer;
+
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const int numSamples = juce::jmin(maxBlockSize, totalSamples - start);
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, numSamples);
+
+        if (dynamic)
+            analyseDynamics(key, start, numSamples);
+
+        // Saturacin antes de los filtros (si est configurada as)
+        if (driveBeforeFilters)
+            drive.process(chunk);
+
+        if (! dynamic)
+        {
+            processFilters(chunk, 0, numSamples);
+        }
+        else
+        {
+            for (int subStart = 0, subBlock = 0; subStart < numSamples; subStart += dynamicSubBlockSize, ++subBlock)
+            {
+                const int subLength = juce::jmin(dynamicSubBlockSize, numSamples - subStart);
+
+                if (topology == Topology::svf)
+                {
+                    for (int band = 0; band < numBands; ++band)
+                        if (detectors[(size_t)band].isEnabled())
+                            applyTableCoefficients(band, gainsDecibels[midComponent][(size_t)band].load()
+                                                       + dynamicGains[(size_t)(band * maxSubBlocks + subBlock)]);
+
+                    processFilters(chunk, subStart, subLength);
+                }
+                else
+                {
+                    for (int step = 0; step < subLength; step += dynamicRampStep)
+                    {
+                        // Fraccin de la rampa alcanzada al final de este paso
+                        const float amount = (float)juce::jmin(step + dynamicRampStep, subLength) / (float)subLength;
+
+                        for (int band = 0; band < numBands; ++band)
+                        {
+                            if (! detectors[(size_t)band].isEnabled())
+                                continue;
+
+                            const float from = previousDynamicGains[(size_t)band];
+                            const float to = dynamicGains[(size_t)(band * maxSubBlocks + subBlock)];
+                            applyTableCoefficients(band, gainsDecibels[midComponent][(size_t)band].load() + from + (to - from) * amount);
+                        }
+
+                        processFilters(chunk, subStart + step, juce::jmin(dynamicRampStep, subLength - step));
+                    }
+                }
 
-    // Recalcula los coeficientes para el filtro de medios
-    *midCoefficients = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 1000.0f, 0.707f, juce::Decibels::decibelsToGain(mid));
+                // Punto de partida de la rampa siguiente (tambin en SVF, por si cambia la topologa)
+                for (int band = 0; band < numBands; ++band)
+                    if (detectors[(size_t)band].isEnabled())
+                        previousDynamicGains[(size_t)band] = dynamicGains[(size_t)(band * maxSubBlocks + subBlock)];
+            }
+        }
 
-    // Recalcula los coeficientes para el filtro de agudos
-    *highCoefficients = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 5000.0f, 0.707f, juce::Decibels::decibelsToGain(high));
+        // Saturacin despus de los filtros
+        if (! driveBeforeFilters)
+            drive.process(chunk);
+    }
 }
 
-// Procesa el buffer de audio aplicando los tres filtros en serie
-void SimpleEQ::process(juce::AudioBuffer<float>& buffer)
+// Evala la respuesta de una banda a partir de su ganancia, sin tocar los filtros del hilo de audio
+float SimpleEQ::getMagnitudeForFrequency(int band, float gainDecibels, double currentSampleRate, double frequency)
 {
-    // Crea un bloque de audio que envuelve al buffer para procesarlo
-    juce::dsp::AudioBlock<float> block(buffer);
+    if (currentSampleRate <= 0.0)
+        return 1.0f;
 
-    // Crea un contexto de procesamiento que reemplaza el buffer original (in-place processing)
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    const auto warp = [currentSampleRate](double f)
+        {
+            // Limita la frecuencia por debajo de Nyquist para que tan() no diverja
+            return static_cast<float>(std::tan(juce::MathConstants<double>::pi * juce::jmin(f, currentSampleRate * 0.499) / currentSampleRate));
+        };
 
-    // Procesa el audio con cada filtro (low, mid, high) aplicndolos en orden
-    lowFilter.process(context);
-    midFilter.process(context);
-    highFilter.process(context);
+    return makeSvfCoefficients(band, warp(bandFrequencies[band]), gainDecibels).getMagnitudeForWarpedFrequency(warp(frequency));
 }
@@ -1,34 +1,163 @@
 #pragma once  // Evita incluir este archivo ms de una vez durante la compilacin
 
 #include <JuceHeader.h>  // Incluye todo JUCE
+#include "DriveStage.h"  // Etapa opcional de saturacin con sobremuestreo
+#include "SvfFilter.h"   // Filtros de variables de estado (TPT/SVF)
+#include "DynamicBandDetector.h" // Detector de envolvente de las bandas dinmicas
+#include "TraceRecorder.h" // Instrumentacin opcional (eventos de traza)
 
 // Clase SimpleEQ: ecualizador simple con tres bandas (bajo, medio, alto)
 class SimpleEQ
 {
 public:
+    // Topologa de los filtros (el orden coincide con las opciones del parmetro "filterTopology")
+    enum class Topology
+    {
+        biquad = 0,  // Biquad RBJ (forma directa), el comportamiento original
+        svf          // Filtro de variables de estado: estable bajo modulacin rpida
+    };
+
+    // Modo estreo (el orden coincide con las opciones del parmetro "stereoMode")
+    enum class StereoMode
+    {
+        leftRight = 0,  // Los dos canales pasan por las mismas bandas
+        midSide         // Los filtros procesan mid y side, cada uno con sus ganancias
+    };
+
+    // ndices de las bandas
+    enum Band { lowBand = 0, midBand, highBand, numBands };
+
+    // Juegos de ganancias: en L/R solo se usa el primero (ambos canales); en M/S, uno para mid y otro para side
+    enum Component { midComponent = 0, sideComponent, numComponents };
+
     SimpleEQ();  // Constructor
 
     // Prepara el procesador con las especificaciones de audio (sample rate, block size, canales)
     void prepare(const juce::dsp::ProcessSpec& spec);
 
-    // Ajusta las ganancias de las tres bandas (low, mid, high)
+    // Limpia el estado de todos los filtros
+    void reset();
+
+    // Cambia la topologa de los filtros; el estado de la nueva topologa arranca limpio
+    void setTopology(Topology newTopology);
+
+    // Ajusta las ganancias de las tres bandas (low, mid, high) en dB (L/R, o mid en modo M/S)
     void setGains(float low, float mid, float high);
 
-    // Procesa un buffer de audio aplicando el ecualizador
-    void process(juce::AudioBuffer<float>& buffer);
+    // Ajusta las ganancias de las tres bandas para la componente side (solo suenan en modo M/S)
+    void setSideGains(float low, float mid, float high);
+
+    // Cambia entre L/R y M/S; el estado de los filtros arranca limpio
+    void setStereoMode(StereoMode newMode);
+
+    // Activa o ajusta la parte dinmica de una banda: su ganancia baja segn la envolvente de la seal
+    // de control (threshold, ratio, attack, release)
+    void setDynamics(int band, const DynamicBandDetector::Settings& settings);
 
-    // Mtodos para acceder a los filtros individuales (constantes, solo lectura)
+    // Configura la etapa de saturacin: curva, drive en dB y si va antes o despus de los filtros
+    void setDrive(DriveStage::Curve curve, float driveDecibels, bool beforeFilters);
 
-    const juce::dsp::IIR::Filter<float>& getLowFilter() const { return lowFilter; }
-    const juce::dsp::IIR::Filter<float>& getMidFilter() const { return midFilter; }
-    const juce::dsp::IIR::Filter<float>& getHighFilter() const { return highFilter; }
+    // Calidad de procesamiento (la ajusta el gobernador de CPU): cada cuntas muestras avanzan los
+    // coeficientes SVF al modularse y cada cuntas cambian los biquad de las bandas dinmicas
+    void setSmoothingInterval(int samples) noexcept { smoothingInterval = juce::jmax(1, samples); }
+    void setDynamicRampStep(int samples) noexcept { dynamicRampStep = juce::jlimit(1, dynamicSubBlockSize, samples); }
+
+    // Latencia total aadida por el ecualizador (solo la saturacin sobremuestreada aade latencia)
+    int getLatencyInSamples() const noexcept { return drive.getLatencyInSamples(); }
+
+    // Procesa un buffer de audio aplicando el ecualizador. keyBuffer es la seal de control de las bandas
+    // dinmicas (sidechain); si es nullptr o no tiene canales se usa la propia entrada
+    void process(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* keyBuffer = nullptr);
+
+    // Ganancia actual de una banda en dB (se puede leer desde cualquier hilo)
+    float getGainDecibels(int band, int component = midComponent) const noexcept { return gainsDecibels[(size_t)component][(size_t)band].load(); }
+
+    // Ajuste dinmico actual de una banda en dB (0 si la banda no es dinmica); cualquier hilo
+    float getDynamicGainDecibels(int band) const noexcept { return dynamicGainsDecibels[(size_t)band].load(); }
+
+    // Resolucin temporal de las bandas dinmicas: la envolvente se actualiza una vez cada
+    // dynamicSubBlockSize muestras. En biquad la ganancia va del valor anterior al nuevo dentro del
+    // sub-bloque en pasos de dynamicRampStep muestras (en SVF los coeficientes se interpolan por muestra)
+    static constexpr int dynamicSubBlockSize = 32;
+
+    // Magnitud de la respuesta de una banda con la ganancia indicada (igual para ambas topologas).
+    // Es esttica para que la interfaz no tenga que leer los filtros del hilo de audio.
+    static float getMagnitudeForFrequency(int band, float gainDecibels, double currentSampleRate, double frequency);
 
 private:
+    // Frecuencia, Q y tipo de cada banda (fijos)
+    static constexpr float bandFrequencies[numBands] = { 100.0f, 1000.0f, 5000.0f };
+    static constexpr float bandQ = 0.707f;
+
+    // Recalcula los coeficientes de una banda de una componente para la topologa activa
+    void updateBand(int component, int band);
+
+    // Actualiza las ganancias de una componente (solo recalcula las bandas que cambiaron)
+    void setComponentGains(int component, const float (&gains)[numBands]);
+
+    // Componente cuyos coeficientes usa cada canal (en M/S el canal 1 lleva la seal side)
+    int getComponent(int channel) const noexcept { return stereoMode == StereoMode::midSide && channel == 1 ? sideComponent : midComponent; }
+
+    // Crea los coeficientes biquad RBJ de una banda para una ganancia
+    juce::dsp::IIR::Coefficients<float>::Ptr makeBiquadCoefficients(int band, float gainDecibels) const;
+
+    // Aplica los filtros de las tres bandas a un tramo del buffer
+    void processFilters(juce::AudioBuffer<float>& buffer, int start, int numSamples);
+
+    // Bandas dinmicas: deteccin sobre la seal de control y coeficientes desde las tablas
+    bool hasDynamicBands() const noexcept;
+    void analyseDynamics(const juce::AudioBuffer<float>& key, int start, int numSamples);
+    void buildCoefficientTables();
+    void applyTableCoefficients(int band, float gainDecibels) noexcept;
+
+    // Crea los coeficientes SVF de una banda (warpedFrequency = tan(pi * fc / fs))
+    static SvfCoefficients makeSvfCoefficients(int band, float warpedFrequency, float gainDecibels) noexcept;
+
+    // Procesa un canal con los filtros SVF, interpolando los coeficientes muestra a muestra
+    void processSvfChannel(int channel, float* data, int numSamples) noexcept;
+
+    // Modo M/S: codifica, filtra y decodifica en un nico recorrido por muestra (sin pasadas extra sobre el buffer)
+    void processMidSideSvf(float* left, float* right, int numSamples) noexcept;
+    void processMidSideBiquad(float* left, float* right, int numSamples) noexcept;
+
     double sampleRate = 44100.0; // Frecuencia de muestreo por defecto
+    Topology topology = Topology::biquad;
+    StereoMode stereoMode = StereoMode::leftRight;
+    int smoothingInterval = 1;  // Muestras entre pasos de la interpolacin de coeficientes SVF
+    int dynamicRampStep = 8;    // Muestras entre cambios de coeficientes biquad de las bandas dinmicas
+
+    // Ganancias actuales en dB por componente; atmicas porque la interfaz las lee para dibujar las curvas
+    std::array<std::array<std::atomic<float>, numBands>, numComponents> gainsDecibels;
+
+    // Filtros IIR (biquad) por canal y por banda; cada canal comparte los coeficientes de la banda
+    // de su componente
+    std::vector<std::array<juce::dsp::IIR::Filter<float>, numBands>> biquadFilters;
+    std::array<std::array<juce::dsp::IIR::Coefficients<float>::Ptr, numBands>, numComponents> biquadCoefficients;
+
+    // Filtros SVF por canal y por banda, y los coeficientes actuales y objetivo de cada componente (para interpolar)
+    std::vector<std::array<SvfFilter, numBands>> svfFilters;
+    std::array<std::array<SvfCoefficients, numBands>, numComponents> svfCurrent, svfTarget;
+
+    // tan(pi * fc / fs) de cada banda: la nica funcin trigonomtrica, calculada en prepare()
+    std::array<float, numBands> warpedFrequencies {};
+
+    // Saturacin opcional; los filtros lineales siguen trabajando a la frecuencia base
+    DriveStage drive;
+    bool driveBeforeFilters = false;
 
-    // Filtros IIR para cada banda del ecualizador
-    juce::dsp::IIR::Filter<float> lowFilter, midFilter, highFilter;
+    // Tablas de coeficientes por banda para ganancias de -48 a +24 dB en pasos de 0.25 dB:
+    // las bandas dinmicas cambian de coeficientes sin recalcular RBJ ni SVF en el hilo de audio.
+    // En modo M/S las bandas dinmicas actan sobre mid
+    static constexpr float tableMinDecibels = -48.0f, tableMaxDecibels = 24.0f, tableStepDecibels = 0.25f;
+    static constexpr int tableSize = 289;
+    std::array<std::vector<SvfCoefficients>, numBands> svfTable;
+    std::array<std::vector<std::array<float, 5>>, numBands> biquadTable;
 
-    // Punteros a las coeficientes de los filtros, que definen sus caractersticas (frecuencia, Q, ganancia)
-    juce::dsp::IIR::Coefficients<float>::Ptr lowCoefficients, midCoefficients, highCoefficients;
+    // Detectores de las bandas dinmicas, mezcla mono de la seal de control y ajuste por sub-bloque
+    std::array<DynamicBandDetector, numBands> detectors;
+    juce::HeapBlock<float> keyMix;
+    std::vector<float> dynamicGains;  // [banda * maxSubBlocks + sub-bloque], en dB
+    std::array<float, numBands> previousDynamicGains {};  // Ajuste del ltimo sub-bloque (inicio de la rampa biquad)
+    int maxBlockSize = 512, maxSubBlocks = 16;
+    std::array<std::atomic<float>, numBands> dynamicGainsDecibels;
 };
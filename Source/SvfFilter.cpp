@@ -0,0 +1,81 @@
+#include "SvfFilter.h"
+
+// Calcula los coeficientes de los integradores a partir de g y k
+void SvfCoefficients::updateIntegrators() noexcept
+{
+    a1 = 1.0f / (1.0f + g * (g + k));
+    a2 = g * a1;
+    a3 = g * a2;
+}
+
+// Low shelf: A = sqrt(ganancia lineal), la frecuencia se escala por 1/sqrt(A) para coincidir con RBJ
+SvfCoefficients SvfCoefficients::makeLowShelf(float warpedFrequency, float q, float gainFactor) noexcept
+{
+    const float A = std::sqrt(gainFactor);
+
+    SvfCoefficients c;
+    c.g = warpedFrequency / std::sqrt(A);
+    c.k = 1.0f / q;
+    c.m0 = 1.0f;
+    c.m1 = c.k * (A - 1.0f);
+    c.m2 = A * A - 1.0f;
+    c.updateIntegrators();
+    return c;
+}
+
+// High shelf: la frecuencia se escala por sqrt(A)
+SvfCoefficients SvfCoefficients::makeHighShelf(float warpedFrequency, float q, float gainFactor) noexcept
+{
+    const float A = std::sqrt(gainFactor);
+
+    SvfCoefficients c;
+    c.g = warpedFrequency * std::sqrt(A);
+    c.k = 1.0f / q;
+    c.m0 = A * A;
+    c.m1 = c.k * (1.0f - A) * A;
+    c.m2 = 1.0f - A * A;
+    c.updateIntegrators();
+    return c;
+}
+
+// Peak (campana): el amortiguamiento depende de la ganancia, igual que en RBJ
+SvfCoefficients SvfCoefficients::makePeak(float warpedFrequency, float q, float gainFactor) noexcept
+{
+    const float A = std::sqrt(gainFactor);
+
+    SvfCoefficients c;
+    c.g = warpedFrequency;
+    c.k = 1.0f / (q * A);
+    c.m0 = 1.0f;
+    c.m1 = c.k * (A * A - 1.0f);
+    c.m2 = 0.0f;
+    c.updateIntegrators();
+    return c;
+}
+
+// H(s) = m0 + (m1 * s + m2) / (s^2 + k * s + 1), con s = j * tan(pi * f / fs) / g
+float SvfCoefficients::getMagnitudeForWarpedFrequency(float warpedFrequency) const noexcept
+{
+    const std::complex<double> s(0.0, (double)warpedFrequency / (double)g);
+    const auto denominator = s * s + (double)k * s + 1.0;
+    const auto H = (double)m0 + ((double)m1 * s + (double)m2) / denominator;
+
+    return static_cast<float>(std::abs(H));
+}
+
+// Incremento lineal por muestra para interpolar los coeficientes de proceso
+SvfCoefficients SvfCoefficients::getIncrementTowards(const SvfCoefficients& target, int numSteps) const noexcept
+{
+    const float scale = 1.0f / (float)juce::jmax(1, numSteps);
+
+    SvfCoefficients d;
+    d.g = (target.g - g) * scale;
+    d.k = (target.k - k) * scale;
+    d.a1 = (target.a1 - a1) * scale;
+    d.a2 = (target.a2 - a2) * scale;
+    d.a3 = (target.a3 - a3) * scale;
+    d.m0 = (target.m0 - m0) * scale;
+    d.m1 = (target.m1 - m1) * scale;
+    d.m2 = (target.m2 - m2) * scale;
+    return d;
+}
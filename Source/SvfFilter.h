@@ -0,0 +1,76 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Coeficientes de un filtro de variables de estado con topología preservada (TPT/SVF, estilo Simper/Zavalishin).
+// Con g = tan(pi * fc / fs) y k = 1/Q las curvas de shelf y peak coinciden con las biquad RBJ,
+// pero el estado del filtro es estable aunque los coeficientes cambien en cada muestra.
+struct SvfCoefficients
+{
+    float g = 0.0f, k = 1.0f;                // Frecuencia pre-deformada y amortiguamiento (para la respuesta en frecuencia)
+    float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;   // Coeficientes de los integradores
+    float m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;   // Mezcla de salidas: entrada, pasa banda y pasa bajos
+
+    // warpedFrequency = tan(pi * fc / fs), que se calcula una sola vez por banda en prepare()
+    static SvfCoefficients makeLowShelf(float warpedFrequency, float q, float gainFactor) noexcept;
+    static SvfCoefficients makeHighShelf(float warpedFrequency, float q, float gainFactor) noexcept;
+    static SvfCoefficients makePeak(float warpedFrequency, float q, float gainFactor) noexcept;
+
+    // Magnitud de la respuesta para una frecuencia ya pre-deformada (tan(pi * f / fs))
+    float getMagnitudeForWarpedFrequency(float warpedFrequency) const noexcept;
+
+    // Diferencia por muestra para llevar estos coeficientes hasta target en numSteps pasos
+    SvfCoefficients getIncrementTowards(const SvfCoefficients& target, int numSteps) const noexcept;
+
+    // Suma un incremento (calculado con getIncrementTowards) a todos los coeficientes, también g y k
+    // para que la respuesta en frecuencia siga a los coeficientes de proceso durante la interpolación
+    void advance(const SvfCoefficients& increment) noexcept
+    {
+        g += increment.g; k += increment.k;
+        a1 += increment.a1; a2 += increment.a2; a3 += increment.a3;
+        m0 += increment.m0; m1 += increment.m1; m2 += increment.m2;
+    }
+
+    bool operator==(const SvfCoefficients& other) const noexcept
+    {
+        return a1 == other.a1 && a2 == other.a2 && a3 == other.a3
+            && m0 == other.m0 && m1 == other.m1 && m2 == other.m2;
+    }
+
+    bool operator!=(const SvfCoefficients& other) const noexcept { return ! (*this == other); }
+
+private:
+    // Calcula a1, a2, a3 a partir de g y k
+    void updateIntegrators() noexcept;
+};
+
+// Filtro SVF de un canal: dos integradores trapezoidales (solo guarda su estado)
+class SvfFilter
+{
+public:
+    // Procesa una muestra con los coeficientes indicados
+    inline float processSample(float v0, const SvfCoefficients& c) noexcept
+    {
+        const float v3 = v0 - ic2eq;
+        const float v1 = c.a1 * ic1eq + c.a2 * v3;
+        const float v2 = ic2eq + c.a2 * ic1eq + c.a3 * v3;
+
+        ic1eq = 2.0f * v1 - ic1eq;
+        ic2eq = 2.0f * v2 - ic2eq;
+
+        return c.m0 * v0 + c.m1 * v1 + c.m2 * v2;
+    }
+
+    // Limpia el estado de los integradores
+    void reset() noexcept { ic1eq = ic2eq = 0.0f; }
+
+    // Evita que el estado quede en valores denormales cuando la señal se apaga
+    void snapToZero() noexcept
+    {
+        if (! (std::abs(ic1eq) > 1.0e-15f)) ic1eq = 0.0f;
+        if (! (std::abs(ic2eq) > 1.0e-15f)) ic2eq = 0.0f;
+    }
+
+private:
+    float ic1eq = 0.0f, ic2eq = 0.0f;  // Estado de los dos integradores
+};
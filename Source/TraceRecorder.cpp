@@ -0,0 +1,273 @@
+#include "TraceRecorder.h"
+
+namespace
+{
+    // Escribe un texto dentro de una cadena JSON: escapa comillas, barras y caracteres de control
+    // (un nombre de hilo con " o \ dejaría el archivo inválido). Sin memoria nueva por evento
+    void writeJsonEscaped(juce::OutputStream& out, const char* text)
+    {
+        for (auto* c = text; *c != 0; ++c)
+        {
+            const auto ch = (unsigned char)*c;
+
+            if (ch == '"' || ch == '\\')
+            {
+                out << '\\' << (char)ch;
+            }
+            else if (ch < 0x20)
+            {
+                const char* hex = "0123456789abcdef";
+                out << "\\u00" << hex[ch >> 4] << hex[ch & 15];
+            }
+            else
+            {
+                out << (char)ch;
+            }
+        }
+    }
+}
+
+TraceRecorder::TraceRecorder() : juce::Thread("Filter_Flow trace writer") {}
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+}
+
+TraceRecorder& TraceRecorder::getInstance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+juce::int64 TraceRecorder::nowNanos() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// El primer usuario arranca la grabación si la variable de entorno indica un archivo de salida
+void TraceRecorder::addUser()
+{
+    const juce::ScopedLock sl(lock);
+
+    if (numUsers++ > 0)
+        return;
+
+    const auto path = juce::SystemStats::getEnvironmentVariable("FILTER_FLOW_TRACE", {});
+    if (path.isNotEmpty() && juce::File::isAbsolutePath(path))
+        start(juce::File(path));
+}
+
+// El último usuario detiene la grabación y cierra el archivo
+void TraceRecorder::removeUser()
+{
+    bool wasLastUser = false;
+
+    {
+        const juce::ScopedLock sl(lock);
+        wasLastUser = (--numUsers == 0);
+    }
+
+    // stop() espera al hilo de escritura, que también usa el lock: se llama fuera de él
+    if (wasLastUser)
+        stop();
+}
+
+// Abre el archivo de salida y arranca el hilo de escritura
+void TraceRecorder::start(const juce::File& outputFile)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (stream != nullptr)
+        return;  // Ya está grabando
+
+    outputFile.deleteFile();
+    stream = std::make_unique<juce::FileOutputStream>(outputFile);
+
+    if (stream->failedToOpen())
+    {
+        stream.reset();
+        return;
+    }
+
+    *stream << "{\"traceEvents\":[\n";
+    firstEventWritten = false;
+    originNanos = nowNanos();
+
+    // Única reserva de memoria: aquí, en el hilo de mensajes, nunca en record()
+    if (buffers == nullptr)
+        buffers = std::make_unique<ThreadBufferArray>();
+
+    // Descarta eventos viejos de una grabación anterior (leyéndolos, para no competir con los escritores)
+    forEachClaimedBuffer([](ThreadBuffer& buffer)
+        {
+            const auto discarded = buffer.fifo.read(buffer.fifo.getNumReady());
+            juce::ignoreUnused(discarded);
+        });
+
+    // La escritura del puntero a las ranuras queda visible para quien vea enabled == true
+    enabled.store(true, std::memory_order_release);
+    startThread(juce::Thread::Priority::low);
+}
+
+// Detiene la grabación, vacía lo pendiente y cierra el archivo
+void TraceRecorder::stop()
+{
+    if (! enabled.exchange(false))
+        return;
+
+    stopThread(1000);
+
+    // Con el hilo de escritura detenido el archivo vuelve a estar protegido por el lock
+    const juce::ScopedLock sl(lock);
+    flush();
+    finishFile();
+    stream.reset();
+}
+
+// Reclama una ranura para el hilo actual la primera vez; el índice se guarda en una variable thread_local
+TraceRecorder::ThreadBuffer* TraceRecorder::getBufferForCurrentThread() noexcept
+{
+    thread_local int currentThreadSlot = -1;
+
+    if (currentThreadSlot < 0)
+        currentThreadSlot = numClaimedBuffers.fetch_add(1, std::memory_order_relaxed);
+
+    if (currentThreadSlot >= maxThreads)
+        return nullptr;
+
+    auto& buffer = (*buffers)[(size_t)currentThreadSlot];
+
+    if (! buffer.claimed.load(std::memory_order_relaxed))
+    {
+        buffer.threadId = (juce::uint64)(juce::pointer_sized_uint)juce::Thread::getCurrentThreadId();
+
+        // Nombres copiados al arreglo fijo: getThreadName() solo copia la referencia del String de JUCE
+        if (juce::MessageManager::existsAndIsCurrentThread())
+            std::snprintf(buffer.threadName, sizeof(buffer.threadName), "Message thread");
+        else if (auto* thread = juce::Thread::getCurrentThread())
+            std::snprintf(buffer.threadName, sizeof(buffer.threadName), "%s", thread->getThreadName().toRawUTF8());
+        else
+            std::snprintf(buffer.threadName, sizeof(buffer.threadName), "Audio thread %llx", (unsigned long long)buffer.threadId);
+
+        // Un nombre recortado puede acabar en medio de un carácter UTF-8: se quita el carácter incompleto
+        const auto length = std::strlen(buffer.threadName);
+        if (length == sizeof(buffer.threadName) - 1)
+        {
+            auto lead = length;
+            while (lead > 0 && ((unsigned char)buffer.threadName[lead - 1] & 0xc0) == 0x80)
+                --lead;
+
+            if (lead > 0 && (unsigned char)buffer.threadName[lead - 1] >= 0xc0)
+            {
+                const auto first = (unsigned char)buffer.threadName[lead - 1];
+                const size_t expected = first >= 0xf0 ? 4 : (first >= 0xe0 ? 3 : 2);
+
+                if (length - (lead - 1) < expected)
+                    buffer.threadName[lead - 1] = 0;
+            }
+        }
+
+        buffer.claimed.store(true, std::memory_order_release);
+    }
+
+    return &buffer;
+}
+
+// Escribe el evento en el buffer del hilo: sin locks ni reservas de memoria, tampoco en el primer evento
+void TraceRecorder::record(const char* name, juce::int64 startNanos, juce::int64 endNanos) noexcept
+{
+    // Acquire: las ranuras reservadas en start() son visibles
+    if (! enabled.load(std::memory_order_acquire))
+        return;
+
+    auto* buffer = getBufferForCurrentThread();
+    if (buffer == nullptr)
+    {
+        droppedThreads.fetch_add(1, std::memory_order_relaxed);  // Sin ranuras libres: se pierde el evento
+        return;
+    }
+
+    const auto scope = buffer->fifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);  // Buffer lleno: se pierde el evento
+        return;
+    }
+
+    const int index = scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2;
+    buffer->events[(size_t)index] = { name, startNanos, endNanos };
+}
+
+// Hilo de escritura: vacía los buffers cada 50 ms. No toma el lock: start() abre el archivo antes de
+// arrancar el hilo y stop() lo cierra después de detenerlo, así que mientras corre el archivo es solo suyo
+void TraceRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        wait(50);
+        flush();
+    }
+}
+
+// Convierte los eventos pendientes de todos los hilos a JSON ("ph":"X" = evento completo, tiempos en µs)
+void TraceRecorder::flush()
+{
+    if (stream == nullptr)
+        return;
+
+    forEachClaimedBuffer([this](ThreadBuffer& buffer)
+        {
+            const auto scope = buffer.fifo.read(buffer.fifo.getNumReady());
+
+            scope.forEach([&](int index)
+                {
+                    const auto& e = buffer.events[(size_t)index];
+
+                    if (firstEventWritten)
+                        *stream << ",\n";
+                    firstEventWritten = true;
+
+                    *stream << "{\"name\":\"";
+                    writeJsonEscaped(*stream, e.name);
+                    *stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (juce::int64)buffer.threadId
+                            << ",\"ts\":" << juce::String((double)(e.start - originNanos) * 0.001, 3)
+                            << ",\"dur\":" << juce::String((double)(e.end - e.start) * 0.001, 3) << "}";
+                });
+        });
+
+    stream->flush();
+}
+
+// Añade los nombres de los hilos (metadatos "ph":"M") y cierra el JSON
+void TraceRecorder::finishFile()
+{
+    if (stream == nullptr)
+        return;
+
+    forEachClaimedBuffer([this](ThreadBuffer& buffer)
+        {
+            if (firstEventWritten)
+                *stream << ",\n";
+            firstEventWritten = true;
+
+            *stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (juce::int64)buffer.threadId
+                    << ",\"args\":{\"name\":\"";
+            writeJsonEscaped(*stream, buffer.threadName);
+            *stream << " (dropped " << (juce::int64)buffer.dropped.load() << ")\"}}";
+        });
+
+    // Los hilos que no consiguieron ranura, si los hubo, se anotan como metadato del proceso
+    if (const auto lost = droppedThreads.load(); lost > 0)
+    {
+        if (firstEventWritten)
+            *stream << ",\n";
+        firstEventWritten = true;
+
+        *stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Filter_Flow (dropped "
+                << (juce::int64)lost << " events from threads without a slot)\"}}";
+    }
+
+    *stream << "\n]}\n";
+    stream->flush();
+}
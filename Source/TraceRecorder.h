@@ -0,0 +1,143 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+// Permite quitar la instrumentación por completo al compilar (FILTER_FLOW_ENABLE_TRACING=0)
+#ifndef FILTER_FLOW_ENABLE_TRACING
+ #define FILTER_FLOW_ENABLE_TRACING 1
+#endif
+
+// Clase TraceRecorder: registro opcional de eventos con marca de tiempo en nanosegundos.
+// Cada hilo reclama una ranura de un arreglo fijo (reservado al arrancar la primera grabación) y escribe en
+// su buffer circular sin locks ni reservas de memoria; un hilo en segundo plano los vacía
+// en un archivo JSON con el formato "trace event" de Chrome/Perfetto (chrome://tracing, ui.perfetto.dev).
+// Se activa definiendo la variable de entorno FILTER_FLOW_TRACE con la ruta del archivo de salida.
+class TraceRecorder : private juce::Thread
+{
+public:
+    // Instancia única compartida por todas las instancias del plugin del proceso
+    static TraceRecorder& getInstance();
+
+    // Comprobación barata (una lectura atómica) que hacen los eventos antes de medir nada
+    static bool isEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    // Cada procesador se registra al crearse; el primero arranca la grabación si FILTER_FLOW_TRACE está definida
+    // y el último en destruirse la detiene y cierra el archivo.
+    void addUser();
+    void removeUser();
+
+    // Arranca y detiene la grabación manualmente
+    void start(const juce::File& outputFile);
+    void stop();
+
+    // Tiempo monotónico en nanosegundos
+    static juce::int64 nowNanos() noexcept;
+
+    // Registra un evento completo en el buffer del hilo actual (el nombre debe ser un literal)
+    void record(const char* name, juce::int64 startNanos, juce::int64 endNanos) noexcept;
+
+    // Evento con ámbito: mide desde su construcción hasta su destrucción
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(const char* eventName) noexcept
+            : name(isEnabled() ? eventName : nullptr),
+              start(name != nullptr ? nowNanos() : 0)
+        {
+        }
+
+        ~ScopedEvent()
+        {
+            if (name != nullptr)
+                getInstance().record(name, start, nowNanos());
+        }
+
+    private:
+        const char* name;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+
+    ~TraceRecorder() override;
+
+private:
+    TraceRecorder();
+
+    struct Event
+    {
+        const char* name;
+        juce::int64 start, end;
+    };
+
+    // Buffer circular de un hilo: un único escritor (el hilo dueño) y un único lector (el hilo de escritura).
+    // El nombre va en un arreglo fijo para no reservar memoria al reclamar la ranura
+    struct ThreadBuffer
+    {
+        static constexpr int capacity = 16384;
+
+        juce::AbstractFifo fifo { capacity };
+        std::array<Event, capacity> events;
+        juce::uint64 threadId = 0;
+        char threadName[64] {};
+        std::atomic<juce::uint64> dropped { 0 };
+        std::atomic<bool> claimed { false };  // Se activa cuando el hilo dueño terminó de rellenar id y nombre
+    };
+
+    // Hilos distintos que pueden registrar eventos; los que llegan después pierden sus eventos
+    static constexpr int maxThreads = 32;
+    using ThreadBufferArray = std::array<ThreadBuffer, maxThreads>;
+
+    // Devuelve el buffer del hilo actual reclamando una ranura la primera vez (un contador atómico, sin
+    // locks); nullptr si ya no quedan ranuras
+    ThreadBuffer* getBufferForCurrentThread() noexcept;
+
+    // Llama a fn con cada ranura ya reclamada (hilo de escritura o con el hilo de escritura detenido)
+    template <typename Function>
+    void forEachClaimedBuffer(Function&& fn)
+    {
+        const int numBuffers = juce::jmin(maxThreads, numClaimedBuffers.load(std::memory_order_acquire));
+
+        for (int i = 0; i < numBuffers; ++i)
+        {
+            auto& buffer = (*buffers)[(size_t)i];
+            if (buffer.claimed.load(std::memory_order_acquire))
+                fn(buffer);
+        }
+    }
+
+    // Bucle del hilo de escritura: vacía los buffers periódicamente
+    void run() override;
+
+    // Escribe en el archivo todos los eventos pendientes
+    void flush();
+
+    // Termina el archivo JSON (nombres de hilos y cierre del array)
+    void finishFile();
+
+    inline static std::atomic<bool> enabled { false };
+
+    // Protege el arranque y la parada y el contador de usuarios. record() nunca lo toma, y el hilo de
+    // escritura tampoco: mientras corre es el único que toca el archivo
+    juce::CriticalSection lock;
+
+    // Ranuras de los hilos (~12 MB): se reservan en el primer start() y viven hasta el final del proceso,
+    // porque cada hilo guarda un puntero a la suya
+    std::unique_ptr<ThreadBufferArray> buffers;
+    std::atomic<int> numClaimedBuffers { 0 };
+    std::atomic<juce::uint64> droppedThreads { 0 };  // Eventos de hilos que no consiguieron ranura
+
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::int64 originNanos = 0;               // Marca de tiempo del inicio de la grabación
+    bool firstEventWritten = false;
+    int numUsers = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
+
+// Macro para instrumentar un ámbito: FILTER_FLOW_TRACE_SCOPE("processBlock");
+#if FILTER_FLOW_ENABLE_TRACING
+ #define FILTER_FLOW_TRACE_SCOPE(name) const TraceRecorder::ScopedEvent JUCE_JOIN_MACRO(traceEvent_, __LINE__) (name)
+#else
+ #define FILTER_FLOW_TRACE_SCOPE(name)
+#endif
@@ -0,0 +1,239 @@
+// AutomationReplay: herramienta de consola que reproduce una captura de automatización (.ffac)
+// a través de Filter_FlowAudioProcessor, bloque a bloque y con los mismos tamaños de bloque que
+// tuvo el host, midiendo el tiempo de cada processBlock. Una captura de campo se convierte así
+// en un benchmark reproducible.
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    // Opciones de la reproducción (se leen de la línea de comandos)
+    struct Options
+    {
+        juce::File captureFile;  // Archivo .ffac a reproducir
+        int repeat = 1;          // Veces que se reproduce la captura completa
+        juce::File csvFile;      // Tiempos por bloque (opcional)
+        bool governor = false;   // Deja actuar al gobernador de CPU (por defecto se desactiva)
+    };
+
+    void printUsage()
+    {
+        std::cout << "Uso: AutomationReplay captura.ffac [opciones]\n"
+                     "  --repeat 1        Veces que se reproduce la captura completa\n"
+                     "  --csv tiempos.csv Guarda el tiempo de cada bloque (bloque, muestras, us, carga)\n"
+                     "  --governor        Respeta el parametro cpuGovernor de la captura\n"
+                     "                    (por defecto se desactiva para que la calidad no dependa del tiempo medido)\n";
+    }
+
+    bool parseOptions(const juce::StringArray& args, Options& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const auto next = [&] { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+            if (arg == "--repeat")         options.repeat = juce::jmax(1, next().getIntValue());
+            else if (arg == "--csv")       options.csvFile = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+            else if (arg == "--governor")  options.governor = true;
+            else if (! arg.startsWith("--") && options.captureFile == juce::File())
+                options.captureFile = juce::File::getCurrentWorkingDirectory().getChildFile(arg);
+            else
+                return false;
+        }
+
+        return options.captureFile.existsAsFile();
+    }
+
+    // Percentil de una lista ya ordenada
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        return sorted[juce::jmin(sorted.size() - 1, (size_t)((double)sorted.size() * fraction))];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;  // Necesario para los timers internos del APVTS
+
+    Options options;
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    if (! parseOptions(args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Lee la captura completa antes de medir: la lectura del archivo no entra en los tiempos
+    AutomationRecorder::Reader reader(options.captureFile);
+    AutomationRecorder::Reader::Header header;
+    juce::String error;
+
+    if (! reader.readHeader(header, error))
+    {
+        std::cerr << options.captureFile.getFullPathName() << ": " << error << "\n";
+        return 1;
+    }
+
+    std::vector<AutomationRecorder::Reader::Block> blocks;
+    for (AutomationRecorder::Reader::Block block; reader.readNextBlock(block);)
+        blocks.push_back(block);
+
+    if (blocks.empty())
+    {
+        std::cerr << "La captura no tiene bloques\n";
+        return 1;
+    }
+
+    auto processor = std::make_unique<Filter_FlowAudioProcessor>();
+    processor->setPlayConfigDetails(header.numInputChannels, header.numOutputChannels, header.sampleRate, header.maxBlockSize);
+
+    // Relaciona cada índice de la captura con el parámetro del mismo ID en esta versión del plugin.
+    // El bypass del host y la compensación de auto gain se graban como índices extra con IDs propios
+    std::vector<juce::RangedAudioParameter*> parameters;
+    int hostBypassIndex = -1, autoGainIndex = -1;
+
+    for (const auto& id : header.parameterIDs)
+    {
+        if (id == AutomationRecorder::hostBypassID)                 hostBypassIndex = (int)parameters.size();
+        else if (id == AutomationRecorder::autoGainCompensationID)  autoGainIndex = (int)parameters.size();
+
+        auto* parameter = processor->parameters.getParameter(id);
+        if (parameter == nullptr && ! id.startsWith("#"))
+            std::cout << "  aviso: el parametro '" << id << "' ya no existe, se ignora\n";
+
+        parameters.push_back(parameter);
+    }
+
+    // Las capturas de la versión 1 no tienen esos valores: la salida puede no coincidir con la sesión
+    if (autoGainIndex < 0)
+        std::cout << "  aviso: la captura no tiene la compensacion de auto gain; con autoGain activo la salida no\n"
+                     "         reproduce la sesion (el timer que la calcula no corre sin bucle de mensajes)\n";
+    if (hostBypassIndex < 0)
+        std::cout << "  aviso: la captura no tiene el bypass del host (processBlockBypassed)\n";
+
+    bool hostBypassed = false;
+
+    auto* governorParameter = processor->parameters.getParameter("cpuGovernor");
+    auto disableGovernor = [&]
+        {
+            if (! options.governor && governorParameter != nullptr && governorParameter->getValue() != 0.0f)
+                governorParameter->setValueNotifyingHost(0.0f);
+        };
+
+    disableGovernor();
+    processor->prepareToPlay(header.sampleRate, header.maxBlockSize);
+
+    // Entrada determinista: ruido blanco a -12 dBFS con semilla fija, recorrido de forma circular
+    const int numChannels = juce::jmax(header.numInputChannels, header.numOutputChannels, 1);
+    const int noiseLength = (int)header.sampleRate;
+    juce::AudioBuffer<float> noise(1, noiseLength);
+    juce::Random random(1234);
+    for (int i = 0; i < noiseLength; ++i)
+        noise.setSample(0, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+    juce::AudioBuffer<float> buffer(numChannels, header.maxBlockSize);
+    juce::MidiBuffer midi;
+
+    std::vector<double> blockMicros, blockLoads;
+    blockMicros.reserve(blocks.size() * (size_t)options.repeat);
+    blockLoads.reserve(blocks.size() * (size_t)options.repeat);
+
+    double checksum = 0.0, audioSeconds = 0.0;
+    int noisePosition = 0, overruns = 0;
+
+    for (int pass = 0; pass < options.repeat; ++pass)
+    {
+        for (const auto& block : blocks)
+        {
+            const int numSamples = juce::jlimit(1, header.maxBlockSize, block.numSamples);
+
+            // Aplica los cambios de parámetros de este bloque, como lo habría hecho el host
+            for (const auto& [index, value] : block.changes)
+            {
+                if (index == hostBypassIndex)
+                    hostBypassed = value > 0.5f;
+                else if (index == autoGainIndex)
+                    processor->setRecordedAutoGainCompensation(value);
+                else if (auto* parameter = parameters[(size_t)index])
+                    parameter->setValueNotifyingHost(value);
+            }
+
+            disableGovernor();
+
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample(ch, i, noise.getSample(0, (noisePosition + i) % noiseLength));
+            noisePosition = (noisePosition + numSamples) % noiseLength;
+
+            const auto start = std::chrono::steady_clock::now();
+            if (hostBypassed)
+                processor->processBlockBypassed(buffer, midi);
+            else
+                processor->processBlock(buffer, midi);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            const double micros = std::chrono::duration<double, std::micro>(elapsed).count();
+            const double budgetMicros = 1.0e6 * numSamples / header.sampleRate;
+
+            blockMicros.push_back(micros);
+            blockLoads.push_back(micros / budgetMicros);
+            if (micros > budgetMicros)
+                ++overruns;
+
+            audioSeconds += numSamples / header.sampleRate;
+
+            // Suma de la salida: dos ejecuciones deterministas deben dar el mismo valor
+            for (int ch = 0; ch < header.numOutputChannels && ch < numChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    checksum += std::abs(buffer.getSample(ch, i));
+        }
+    }
+
+    processor->releaseResources();
+
+    if (options.csvFile != juce::File())
+    {
+        juce::String csv = "block,samples,micros,load\n";
+        for (size_t i = 0; i < blockMicros.size(); ++i)
+            csv << (int)i << "," << blocks[i % blocks.size()].numSamples << ","
+                << juce::String(blockMicros[i], 2) << "," << juce::String(blockLoads[i], 4) << "\n";
+
+        options.csvFile.replaceWithText(csv);
+    }
+
+    double totalMicros = 0.0;
+    for (auto t : blockMicros)
+        totalMicros += t;
+
+    auto sorted = blockMicros;
+    std::sort(sorted.begin(), sorted.end());
+
+    const double maxLoad = *std::max_element(blockLoads.begin(), blockLoads.end());
+
+    std::cout << "Filter_Flow automation replay\n"
+              << "  captura " << options.captureFile.getFileName() << ": " << blocks.size() << " bloques, "
+              << header.parameterIDs.size() << " parametros, " << header.sampleRate << " Hz, bloque max "
+              << header.maxBlockSize << ", " << header.numInputChannels << " in / " << header.numOutputChannels << " out\n";
+
+    if (reader.getDroppedBlocks() > 0)
+        std::cout << "  aviso: la captura perdio " << reader.getDroppedBlocks() << " bloques (FIFO llena)\n";
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "  pasadas " << options.repeat << ", audio " << audioSeconds << " s, CPU " << totalMicros / 1000.0 << " ms"
+              << " (" << 100.0 * totalMicros / (audioSeconds * 1.0e6) << " % de tiempo real)\n"
+              << "  us por bloque: media " << totalMicros / (double)blockMicros.size()
+              << ", p50 " << percentile(sorted, 0.5) << ", p99 " << percentile(sorted, 0.99)
+              << ", max " << sorted.back() << "\n"
+              << "  carga max " << 100.0 * maxLoad << " %, bloques fuera de plazo " << overruns << "\n"
+              << std::setprecision(6) << "  checksum de salida " << checksum << "\n";
+
+    return 0;
+}
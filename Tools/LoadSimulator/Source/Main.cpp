@@ -0,0 +1,336 @@
+// LoadSimulator: herramienta de consola que crea N instancias de Filter_FlowAudioProcessor
+// y las procesa como lo haría un host con un grafo paralelo, midiendo cuántas instancias
+// caben por núcleo antes de perder el plazo (deadline) de cada ciclo de audio.
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "WorkStealingPool.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    // Opciones de la simulación (se leen de la línea de comandos)
+    struct Options
+    {
+        juce::Array<int> instanceCounts { 1, 16, 64, 256 };  // Valores de N a probar
+        juce::Array<int> threadCounts { 1, 2, 4 };            // Número de hilos a probar
+        int blockSize = 256;                                  // Muestras por ciclo
+        double sampleRate = 48000.0;                          // Frecuencia de muestreo
+        int cycles = 2000;                                    // Ciclos medidos por combinación
+        int chainLength = 1;                                  // Instancias en serie dentro de cada pista
+        bool padded = true;                                   // Contadores y buffers alineados a línea de caché
+        bool drive = false;                                   // Activa la saturación sobremuestreada
+        bool fullChain = false;                               // Activa banda dinámica y limitador con true peak
+        juce::Array<int> tiers { (int)CpuGovernor::Tier::full };  // Niveles de calidad a probar (fijos)
+    };
+
+    // Nombres de los niveles en la línea de comandos ("full", "reduced", "minimal")
+    juce::Array<int> parseTiers(const juce::String& text)
+    {
+        juce::Array<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            for (int tier = 0; tier < (int)CpuGovernor::Tier::numTiers; ++tier)
+                if (token.equalsIgnoreCase(CpuGovernor::getSettings((CpuGovernor::Tier)tier).name))
+                    values.add(tier);
+        return values;
+    }
+
+    juce::Array<int> parseList(const juce::String& text)
+    {
+        juce::Array<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            if (token.getIntValue() > 0)
+                values.add(token.getIntValue());
+        return values;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Uso: LoadSimulator [opciones]\n"
+                     "  --instances 1,16,64,256   Numero de instancias (N) a probar\n"
+                     "  --threads 1,2,4           Numero de hilos (incluye el hilo principal)\n"
+                     "  --block 256               Tamano de bloque en muestras\n"
+                     "  --rate 48000              Frecuencia de muestreo\n"
+                     "  --cycles 2000             Ciclos medidos por combinacion\n"
+                     "  --chain 1                 Instancias en serie por pista (nodo del grafo)\n"
+                     "  --layout padded|packed    Alineacion de contadores y buffers por hilo/instancia\n"
+                     "  --drive                   Activa la saturacion sobremuestreada en todas las instancias\n"
+                     "  --full-chain              Activa una banda dinamica y el limitador con true peak\n"
+                     "  --tiers full,reduced,minimal  Niveles de calidad del gobernador a comparar (fijos)\n";
+    }
+
+    bool parseOptions(const juce::StringArray& args, Options& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const auto next = [&] { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+            if (arg == "--instances")    options.instanceCounts = parseList(next());
+            else if (arg == "--threads") options.threadCounts = parseList(next());
+            else if (arg == "--block")   options.blockSize = juce::jmax(1, next().getIntValue());
+            else if (arg == "--rate")    options.sampleRate = juce::jmax(8000.0, next().getDoubleValue());
+            else if (arg == "--cycles")  options.cycles = juce::jmax(1, next().getIntValue());
+            else if (arg == "--chain")   options.chainLength = juce::jmax(1, next().getIntValue());
+            else if (arg == "--layout")  options.padded = next() != "packed";
+            else if (arg == "--drive")   options.drive = true;
+            else if (arg == "--full-chain") options.fullChain = true;
+            else if (arg == "--tiers")   options.tiers = parseTiers(next());
+            else
+                return false;
+        }
+
+        return ! options.instanceCounts.isEmpty() && ! options.threadCounts.isEmpty() && ! options.tiers.isEmpty();
+    }
+
+    // Conjunto de instancias y sus buffers. Los buffers viven en un único bloque de memoria:
+    // "packed" los deja contiguos y "padded" separa cada canal a su propia línea de caché.
+    struct InstanceSet
+    {
+        InstanceSet(int numInstances, const Options& options)
+        {
+            const int cacheLineFloats = 64 / (int)sizeof(float);
+            channelStride = options.padded ? ((options.blockSize + cacheLineFloats - 1) / cacheLineFloats + 1) * cacheLineFloats
+                                           : options.blockSize;
+
+            const int numTracks = (numInstances + options.chainLength - 1) / options.chainLength;
+            arena.allocate((size_t)(numTracks * 2 * channelStride + cacheLineFloats), true);
+
+            for (int track = 0; track < numTracks; ++track)
+            {
+                float* left = arena + track * 2 * channelStride;
+                float* right = left + channelStride;
+                channelPointers.add(left);
+                channelPointers.add(right);
+            }
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                auto processor = std::make_unique<Filter_FlowAudioProcessor>();
+                processor->setPlayConfigDetails(2, 2, options.sampleRate, options.blockSize);
+
+                // Ajustes típicos de una sesión: bandas con ganancia y, opcionalmente, saturación
+                auto setParameter = [&](const char* id, float value)
+                    {
+                        if (auto* parameter = processor->parameters.getParameter(id))
+                            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+                    };
+
+                setParameter("lowGain", 3.0f);
+                setParameter("midGain", -2.0f);
+                setParameter("highGain", 4.0f);
+                if (options.drive)
+                    setParameter("driveCurve", 2.0f);
+
+                // Las etapas cuyo coste reducen los niveles de calidad del gobernador
+                if (options.fullChain)
+                {
+                    setParameter("lowDynamic", 1.0f);
+                    setParameter("lowThreshold", -30.0f);
+                    setParameter("limiter", 1.0f);
+                    setParameter("limiterTruePeak", 1.0f);
+                }
+
+                processor->prepareToPlay(options.sampleRate, options.blockSize);
+                instances.push_back(std::move(processor));
+            }
+
+            // Señal de entrada: ruido blanco a -12 dBFS, copiada al buffer de cada pista en cada ciclo
+            noise.setSize(1, options.blockSize);
+            juce::Random random(1234);
+            for (int i = 0; i < options.blockSize; ++i)
+                noise.setSample(0, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+        }
+
+        // Fija el nivel de calidad de todas las instancias (el gobernador deja de decidir)
+        void forceTier(int tier)
+        {
+            for (auto& processor : instances)
+                processor->cpuGovernor.forceTier((CpuGovernor::Tier)tier);
+        }
+
+        std::vector<std::unique_ptr<Filter_FlowAudioProcessor>> instances;
+        juce::HeapBlock<float> arena;
+        juce::Array<float*> channelPointers;
+        juce::AudioBuffer<float> noise;
+        int channelStride = 0;
+    };
+
+    // Estadísticas de una combinación (N, hilos)
+    struct RunResult
+    {
+        double meanMicros = 0, p99Micros = 0, maxMicros = 0;
+        int misses = 0;
+        juce::uint64 steals = 0;
+
+        // Reparto entre trabajadores: tareas y utilización (tiempo ocupado / tiempo total medido)
+        std::vector<juce::uint64> workerTasks;
+        std::vector<double> workerUtilization;
+        double imbalance = 1.0;  // Tiempo ocupado del trabajador más cargado / media de todos
+    };
+
+    RunResult runSimulation(InstanceSet& set, int numThreads, const Options& options)
+    {
+        WorkStealingPool pool(numThreads, options.padded);
+
+        const int numInstances = (int)set.instances.size();
+        const int numTracks = set.channelPointers.size() / 2;
+        const double budgetMicros = 1.0e6 * options.blockSize / options.sampleRate;
+
+        // Cada tarea es una pista: copia la entrada y la pasa por sus instancias en serie
+        auto processTrack = [&](int track)
+            {
+                juce::ScopedNoDenormals noDenormals;
+
+                float* channels[2] = { set.channelPointers[track * 2], set.channelPointers[track * 2 + 1] };
+                juce::FloatVectorOperations::copy(channels[0], set.noise.getReadPointer(0), options.blockSize);
+                juce::FloatVectorOperations::copy(channels[1], set.noise.getReadPointer(0), options.blockSize);
+
+                juce::AudioBuffer<float> buffer(channels, 2, options.blockSize);
+                juce::MidiBuffer localMidi;
+
+                const int first = track * options.chainLength;
+                const int last = juce::jmin(numInstances, first + options.chainLength);
+
+                for (int i = first; i < last; ++i)
+                    set.instances[(size_t)i]->processBlock(buffer, localMidi);
+            };
+
+        // Ciclos de calentamiento (cachés, rampas de parámetros, predictor de saltos)
+        for (int i = 0; i < juce::jmin(100, options.cycles); ++i)
+            pool.runCycle(numTracks, processTrack);
+
+        std::vector<double> cycleMicros;
+        cycleMicros.reserve((size_t)options.cycles);
+
+        // Los contadores solo cuentan los ciclos medidos
+        for (int w = 0; w < numThreads; ++w)
+        {
+            auto& counters = pool.getCounters(w);
+            counters.tasks.store(0);
+            counters.steals.store(0);
+            counters.busyNanos.store(0);
+        }
+
+        for (int i = 0; i < options.cycles; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            pool.runCycle(numTracks, processTrack);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            cycleMicros.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+        }
+
+        RunResult result;
+        for (auto t : cycleMicros)
+        {
+            result.meanMicros += t;
+            result.maxMicros = juce::jmax(result.maxMicros, t);
+            if (t > budgetMicros)
+                ++result.misses;
+        }
+        result.meanMicros /= (double)cycleMicros.size();
+
+        std::sort(cycleMicros.begin(), cycleMicros.end());
+        result.p99Micros = cycleMicros[juce::jmin(cycleMicros.size() - 1, (size_t)((double)cycleMicros.size() * 0.99))];
+
+        double wallNanos = 0.0;
+        for (auto t : cycleMicros)
+            wallNanos += 1000.0 * t;
+
+        double totalBusyNanos = 0.0, maxBusyNanos = 0.0;
+
+        for (int w = 0; w < numThreads; ++w)
+        {
+            const auto& counters = pool.getCounters(w);
+            const double busyNanos = (double)counters.busyNanos.load();
+
+            result.steals += counters.steals.load();
+            result.workerTasks.push_back(counters.tasks.load());
+            result.workerUtilization.push_back(wallNanos > 0.0 ? busyNanos / wallNanos : 0.0);
+
+            totalBusyNanos += busyNanos;
+            maxBusyNanos = juce::jmax(maxBusyNanos, busyNanos);
+        }
+
+        if (totalBusyNanos > 0.0)
+            result.imbalance = maxBusyNanos * numThreads / totalBusyNanos;
+
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;  // Necesario para los timers internos del APVTS
+
+    Options options;
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    if (! parseOptions(args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    const double budgetMicros = 1.0e6 * options.blockSize / options.sampleRate;
+
+    std::cout << "Filter_Flow load simulator\n"
+              << "  block " << options.blockSize << " @ " << options.sampleRate << " Hz, deadline " << std::fixed
+              << std::setprecision(1) << budgetMicros << " us, chain " << options.chainLength
+              << ", layout " << (options.padded ? "padded" : "packed") << (options.drive ? ", drive on" : "")
+              << (options.fullChain ? ", full chain" : "") << "\n"
+              << "  sizeof(Filter_FlowAudioProcessor) = " << sizeof(Filter_FlowAudioProcessor) << " bytes\n"
+              << "  hardware threads: " << juce::SystemStats::getNumCpus() << "\n\n";
+
+    std::cout << std::setw(8) << "N" << std::setw(9) << "tier" << std::setw(9) << "threads" << std::setw(12) << "mean us" << std::setw(12) << "p99 us"
+              << std::setw(12) << "max us" << std::setw(9) << "load %" << std::setw(9) << "miss %" << std::setw(12) << "ns/inst"
+              << std::setw(12) << "inst/core" << std::setw(10) << "steals" << std::setw(8) << "imbal" << "\n";
+
+    for (auto numInstances : options.instanceCounts)
+    {
+        InstanceSet set(numInstances, options);
+
+        for (auto tier : options.tiers)
+        {
+            set.forceTier(tier);
+
+            for (auto numThreads : options.threadCounts)
+            {
+                const auto r = runSimulation(set, numThreads, options);
+
+                // Coste por instancia y bloque en tiempo de CPU (todos los hilos sumados)
+                const double nsPerInstance = 1000.0 * r.meanMicros * numThreads / numInstances;
+
+                // Instancias que un núcleo puede sostener sin pasarse del plazo, usando el p99 como referencia
+                const double instancesPerCore = (double)numInstances * budgetMicros / (r.p99Micros * numThreads);
+
+                std::cout << std::setw(8) << numInstances << std::setw(9) << CpuGovernor::getSettings((CpuGovernor::Tier)tier).name
+                          << std::setw(9) << numThreads
+                          << std::setw(12) << std::setprecision(1) << r.meanMicros
+                          << std::setw(12) << r.p99Micros
+                          << std::setw(12) << r.maxMicros
+                          << std::setw(9) << 100.0 * r.meanMicros / budgetMicros
+                          << std::setw(9) << std::setprecision(2) << 100.0 * r.misses / options.cycles
+                          << std::setw(12) << std::setprecision(0) << nsPerInstance
+                          << std::setw(12) << std::setprecision(1) << instancesPerCore
+                          << std::setw(10) << r.steals
+                          << std::setw(8) << std::setprecision(2) << r.imbalance << "\n";
+
+                // Detalle por trabajador (el 0 es el hilo que lanza cada ciclo)
+                if (numThreads > 1)
+                {
+                    for (int w = 0; w < numThreads; ++w)
+                        std::cout << std::setw(17) << "worker " << w << ": " << r.workerTasks[(size_t)w] << " tasks, "
+                                  << std::setprecision(1) << 100.0 * r.workerUtilization[(size_t)w] << " % busy\n";
+                }
+            }
+        }
+    }
+
+    return 0;
+}
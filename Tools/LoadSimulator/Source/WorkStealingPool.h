@@ -0,0 +1,221 @@
+#pragma once  // Evita incluir este archivo más de una vez durante la compilación
+
+#include <JuceHeader.h>  // Incluye todo JUCE
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Pool de hilos con robo de trabajo, pensado para simular cómo un host reparte los nodos de su grafo.
+// Cada ciclo de audio se reparte en colas por hilo; un hilo sin trabajo roba del frente de las colas ajenas.
+// El hilo que llama a runCycle participa como trabajador 0, igual que el hilo de audio de un host.
+class WorkStealingPool
+{
+public:
+    // Contadores por trabajador; se actualizan en cada tarea para poder medir el efecto del "false sharing"
+    struct WorkerCounters
+    {
+        std::atomic<juce::uint64> tasks { 0 };      // Tareas ejecutadas
+        std::atomic<juce::uint64> steals { 0 };     // Tareas robadas de otra cola
+        std::atomic<juce::uint64> busyNanos { 0 };  // Tiempo ocupado en tareas (ns)
+    };
+
+    // numThreads incluye al hilo que llama a runCycle.
+    // padCounters = true alinea los contadores de cada hilo a su propia línea de caché.
+    WorkStealingPool(int numThreads, bool padCounters)
+        : numWorkers(juce::jmax(1, numThreads)), padded(padCounters)
+    {
+        queues = std::make_unique<Queue[]>((size_t)numWorkers);
+        idleWorkers.store(numWorkers - 1);  // Al principio todos los hilos están esperando
+
+        if (padded)
+            paddedCounters = std::make_unique<PaddedWorkerCounters[]>((size_t)numWorkers);
+        else
+            packedCounters = std::make_unique<WorkerCounters[]>((size_t)numWorkers);
+
+        // Los hilos 1..N-1 son propios del pool; el 0 es el que llama a runCycle.
+        // La generación de partida se lee aquí, antes de crear ningún hilo: si un hilo la leyera al
+        // arrancar, podría tomar como punto de partida la del primer ciclo, saltárselo y no marcarse
+        // nunca como libre (el primer runCycle esperaría para siempre)
+        const auto startGeneration = generation.load();
+
+        for (int i = 1; i < numWorkers; ++i)
+            threads.emplace_back([this, i, startGeneration] { workerLoop(i, startGeneration); });
+    }
+
+    ~WorkStealingPool()
+    {
+        shouldExit.store(true);
+        generation.fetch_add(1);
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+    WorkerCounters& getCounters(int worker) noexcept
+    {
+        return padded ? paddedCounters[(size_t)worker].counters : packedCounters[(size_t)worker];
+    }
+
+    // Ejecuta las tareas 0..numTasks-1 y bloquea hasta que terminen todas.
+    // La función debe seguir viva durante la llamada (no se copia para no reservar memoria por ciclo).
+    template <typename TaskFunction>
+    void runCycle(int numTasks, TaskFunction& function)
+    {
+        waitForIdleWorkers();  // Ningún hilo puede seguir mirando las colas del ciclo anterior
+        idleWorkers.store(0);
+
+        // Reparte las tareas en turnos entre las colas (como un host repartiendo pistas)
+        for (int w = 0; w < numWorkers; ++w)
+            queues[(size_t)w].clear();
+
+        for (int task = 0; task < numTasks; ++task)
+            queues[(size_t)(task % numWorkers)].push(task);
+
+        currentTask = [] (void* context, int task) { (*static_cast<TaskFunction*>(context))(task); };
+        currentContext = &function;
+        remaining.store(numTasks);
+
+        generation.fetch_add(1, std::memory_order_acq_rel);  // Despierta a los trabajadores
+
+        runTasks(0);
+
+        // Espera activa a que los demás hilos terminen sus tareas (como el hilo de audio de un host)
+        while (remaining.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+
+        waitForIdleWorkers();
+    }
+
+private:
+    // Cola de tareas de un trabajador: el dueño saca del final y los demás roban del frente
+    struct Queue
+    {
+        void clear()
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            head = tail = 0;
+            items.clearQuick();
+        }
+
+        void push(int task)
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            items.add(task);
+            ++tail;
+        }
+
+        bool popBack(int& task)
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            if (head == tail)
+                return false;
+
+            task = items.getUnchecked(--tail);
+            return true;
+        }
+
+        bool stealFront(int& task)
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            if (head == tail)
+                return false;
+
+            task = items.getUnchecked(head++);
+            return true;
+        }
+
+        juce::SpinLock lock;
+        juce::Array<int> items;
+        int head = 0, tail = 0;
+    };
+
+    struct alignas(64) PaddedWorkerCounters
+    {
+        WorkerCounters counters;
+    };
+
+    // Espera a que todos los hilos propios del pool hayan terminado el ciclo actual
+    void waitForIdleWorkers() const
+    {
+        while (idleWorkers.load(std::memory_order_acquire) < numWorkers - 1)
+            std::this_thread::yield();
+    }
+
+    // Bucle de los hilos del pool: espera un nuevo ciclo y ejecuta tareas hasta vaciar todas las colas
+    void workerLoop(int worker, juce::uint64 startGeneration)
+    {
+        auto seenGeneration = startGeneration;
+
+        for (;;)
+        {
+            while (generation.load(std::memory_order_acquire) == seenGeneration)
+                std::this_thread::yield();
+
+            seenGeneration = generation.load(std::memory_order_acquire);
+
+            if (shouldExit.load())
+                return;
+
+            runTasks(worker);
+            idleWorkers.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    // Saca tareas de la cola propia y, cuando se vacía, roba de las demás
+    void runTasks(int worker)
+    {
+        auto& counters = getCounters(worker);
+        int task = 0;
+
+        for (;;)
+        {
+            bool stolen = false;
+
+            if (! queues[(size_t)worker].popBack(task))
+            {
+                bool found = false;
+
+                for (int offset = 1; offset < numWorkers && ! found; ++offset)
+                    found = queues[(size_t)((worker + offset) % numWorkers)].stealFront(task);
+
+                if (! found)
+                    return;  // Todas las colas están vacías: no queda trabajo en este ciclo
+
+                stolen = true;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            currentTask(currentContext, task);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            counters.tasks.fetch_add(1, std::memory_order_relaxed);
+            counters.busyNanos.fetch_add((juce::uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                         std::memory_order_relaxed);
+            if (stolen)
+                counters.steals.fetch_add(1, std::memory_order_relaxed);
+
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    const int numWorkers;
+    const bool padded;
+
+    std::unique_ptr<Queue[]> queues;
+    std::unique_ptr<WorkerCounters[]> packedCounters;
+    std::unique_ptr<PaddedWorkerCounters[]> paddedCounters;
+    std::vector<std::thread> threads;
+
+    void (*currentTask)(void*, int) = nullptr;
+    void* currentContext = nullptr;
+
+    std::atomic<juce::uint64> generation { 0 };
+    std::atomic<int> remaining { 0 };
+    std::atomic<int> idleWorkers { 0 };
+    std::atomic<bool> shouldExit { false };
+
+    JUCE_DECLARE_NON_COPYABLE(WorkStealingPool)
+};